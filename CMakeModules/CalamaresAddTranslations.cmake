@@ -91,11 +91,14 @@ macro(add_calamares_translations language)
         MAIN_DEPENDENCY ${trans_srcfile}
     )
 
-    # Run the resource compiler (rcc_options should already be set)
+    # Run the resource compiler (rcc_options should already be set).
+    # The catalogues are not compressed, so that QTranslator can use
+    # them straight from the (mapped) executable instead of unpacking
+    # a copy each time the language changes.
     add_custom_command(
         OUTPUT ${trans_outfile}
         COMMAND "${Qt5Core_RCC_EXECUTABLE}"
-        ARGS ${rcc_options} ${_rcc_version_support} -name ${trans_file} -o ${trans_outfile} ${trans_infile}
+        ARGS ${rcc_options} ${_rcc_version_support} -no-compress -name ${trans_file} -o ${trans_outfile} ${trans_infile}
         MAIN_DEPENDENCY ${trans_infile}
         DEPENDS ${QM_FILES}
     )
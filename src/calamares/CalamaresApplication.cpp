@@ -29,6 +29,7 @@
 #include "Settings.h"
 #include "ViewManager.h"
 #include "modulesystem/ModuleManager.h"
+#include "partition/DeviceInventory.h"
 #include "utils/CalamaresUtilsGui.h"
 #include "utils/CalamaresUtilsSystem.h"
 #include "utils/Dirs.h"
@@ -74,6 +75,10 @@ CalamaresApplication::init()
 
     setQuitOnLastWindowClosed( false );
 
+    // Scanning the disks is slow; both the requirements checker and the
+    // partition module use the results, so start right away.
+    CalamaresUtils::Partition::DeviceInventory::instance().refresh();
+
     initQmlPath();
     initSettings();
     initBranding();
@@ -352,6 +357,7 @@ CalamaresApplication::initView()
 
     m_mainwindow = new CalamaresWindow();  //also creates ViewManager
 
+    connect( m_moduleManager, &Calamares::ModuleManager::viewStepsAvailable, this, &CalamaresApplication::initWindow );
     connect( m_moduleManager, &Calamares::ModuleManager::modulesLoaded, this, &CalamaresApplication::initViewSteps );
     connect( m_moduleManager, &Calamares::ModuleManager::modulesFailed, this, &CalamaresApplication::initFailed );
 
@@ -364,10 +370,13 @@ CalamaresApplication::initView()
 
 
 void
-CalamaresApplication::initViewSteps()
+CalamaresApplication::initWindow()
 {
-    cDebug() << "STARTUP: loadModules for all modules done";
-    m_moduleManager->checkRequirements();
+    if ( m_mainwindow->isVisible() )
+    {
+        return;
+    }
+
     if ( Calamares::Branding::instance()->windowMaximize() )
     {
         m_mainwindow->setWindowFlag( Qt::FramelessWindowHint );
@@ -377,20 +386,33 @@ CalamaresApplication::initViewSteps()
     {
         m_mainwindow->show();
     }
+    cDebug() << "STARTUP: Window now visible";
 
-    ProgressTreeModel* m = new ProgressTreeModel( nullptr );
-    ProgressTreeView::instance()->setModel( m );
-    cDebug() << "STARTUP: Window now visible and ProgressTreeView populated";
-
-    const auto steps = Calamares::ViewManager::instance()->viewSteps();
-    cDebug() << Logger::SubEntry << steps.count() << "view steps loaded.";
     // Tell the first view that it's been shown.
+    const auto steps = Calamares::ViewManager::instance()->viewSteps();
     if ( steps.count() > 0 )
     {
         steps[ 0 ]->onActivate();
     }
 }
 
+
+void
+CalamaresApplication::initViewSteps()
+{
+    cDebug() << "STARTUP: loadModules for all modules done";
+    m_moduleManager->checkRequirements();
+    // Usually the window is shown already, as soon as the first view step was loaded
+    initWindow();
+
+    ProgressTreeModel* m = new ProgressTreeModel( nullptr );
+    ProgressTreeView::instance()->setModel( m );
+    cDebug() << "STARTUP: ProgressTreeView populated";
+
+    const auto steps = Calamares::ViewManager::instance()->viewSteps();
+    cDebug() << Logger::SubEntry << steps.count() << "view steps loaded.";
+}
+
 void
 CalamaresApplication::initFailed( const QStringList& l )
 {
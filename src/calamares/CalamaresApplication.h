@@ -66,6 +66,7 @@ public:
 
 private slots:
     void initView();
+    void initWindow();
     void initViewSteps();
     void initFailed( const QStringList& l );
 
@@ -127,7 +127,11 @@ CalamaresWindow::CalamaresWindow( QWidget* parent )
     }
     logoLabel->setAlignment( Qt::AlignCenter );
     logoLabel->setFixedSize( 80, 80 );
-    logoLabel->setPixmap( branding->image( Calamares::Branding::ProductLogo, logoLabel->size() ) );
+    // An SVG logo is rendered in the background, the label gets it when done
+    logoLabel->setPixmap( branding->imageAsync( Calamares::Branding::ProductLogo,
+                                                logoLabel->size(),
+                                                logoLabel,
+                                                [logoLabel]( const QPixmap& p ) { logoLabel->setPixmap( p ); } ) );
     logoLayout->addWidget( logoLabel );
     logoLayout->addStretch();
 
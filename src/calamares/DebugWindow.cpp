@@ -92,12 +92,24 @@ DebugWindow::DebugWindow()
 
     m_ui->globalStorageView->setModel( m_globals_model.get() );
     m_ui->globalStorageView->expandAll();
-
-    // Do above when the GS changes, too
-    connect( gs, &GlobalStorage::changed, this, [=] {
-        m_globals = JobQueue::instance()->globalStorage()->data();
-        m_globals_model->reload();
-        m_ui->globalStorageView->expandAll();
+    // If reloading changes the shape of the tree, the model is reset
+    connect( m_globals_model.get(),
+             &QAbstractItemModel::modelReset,
+             m_ui->globalStorageView,
+             &QTreeView::expandAll );
+
+    // Do above when the GS changes, too. GS may change many times in a row
+    // (e.g. in the partitioning module), so pick up the changes at most a
+    // few times per second, and not at all while the window is hidden.
+    m_globalsTimer.setSingleShot( true );
+    m_globalsTimer.setInterval( 250 );
+    connect( &m_globalsTimer, &QTimer::timeout, this, &DebugWindow::updateGlobals );
+    connect( gs, &GlobalStorage::changed, this, [this] {
+        m_globalsStale = true;
+        if ( isVisible() && !m_globalsTimer.isActive() )
+        {
+            m_globalsTimer.start();
+        }
     } );
 
     // JobQueue page
@@ -118,6 +130,8 @@ DebugWindow::DebugWindow()
     m_ui->modulesListView->setSelectionMode( QAbstractItemView::SingleSelection );
 
     m_ui->moduleConfigView->setModel( m_module_model.get() );
+    connect(
+        m_module_model.get(), &QAbstractItemModel::modelReset, m_ui->moduleConfigView, &QTreeView::expandAll );
 
 #ifdef WITH_PYTHONQT
     QPushButton* pythonConsoleButton = new QPushButton;
@@ -192,7 +206,6 @@ DebugWindow::DebugWindow()
                  {
                      m_module = module->configurationMap();
                      m_module_model->reload();
-                     m_ui->moduleConfigView->expandAll();
                      m_ui->moduleTypeLabel->setText( module->typeString() );
                      m_ui->moduleInterfaceLabel->setText( module->interfaceString() );
 #ifdef WITH_PYTHONQT
@@ -233,4 +246,22 @@ DebugWindow::closeEvent( QCloseEvent* e )
     emit closed();
 }
 
+void
+DebugWindow::showEvent( QShowEvent* e )
+{
+    QWidget::showEvent( e );
+    if ( m_globalsStale )
+    {
+        updateGlobals();
+    }
+}
+
+void
+DebugWindow::updateGlobals()
+{
+    m_globalsStale = false;
+    m_globals = JobQueue::instance()->globalStorage()->data();
+    m_globals_model->reload();
+}
+
 }  // namespace Calamares
@@ -22,6 +22,7 @@
 
 #include "VariantModel.h"
 
+#include <QTimer>
 #include <QVariant>
 #include <QWidget>
 
@@ -48,9 +49,15 @@ signals:
 
 protected:
     void closeEvent( QCloseEvent* e ) override;
+    void showEvent( QShowEvent* e ) override;
 
 private:
+    /// @brief Copies GlobalStorage into the globals model
+    void updateGlobals();
+
     Ui::DebugWindow* m_ui;
+    QTimer m_globalsTimer;
+    bool m_globalsStale = false;
     QVariant m_globals;
     QVariant m_module;
     std::unique_ptr< VariantModel > m_globals_model;
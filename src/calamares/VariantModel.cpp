@@ -18,62 +18,70 @@
 
 #include "VariantModel.h"
 
+#include <algorithm>
+
+/** @brief Appends @p item, and then its children, to @p nodes
+ *
+ * The @p key is what is shown for the item in the first column.
+ */
 static void
-overallLength( const QVariant& item, quintptr& c, quintptr parent, VariantModel::IndexVector* skiplist )
+addNodes( const QVariant& item, const QVariant& key, quintptr parent, VariantModel::NodeVector& nodes )
 {
-    if ( skiplist )
+    const quintptr self = static_cast< quintptr >( nodes.count() );
+    {
+        VariantModel::Node node;
+        node.parent = parent;
+        node.row = parent < self ? nodes[ static_cast< int >( parent ) ].children.count() : 0;
+        node.key = key;
+        node.value = item;
+        nodes.append( node );
+    }
+    if ( parent < self )
     {
-        skiplist->append( parent );
+        nodes[ static_cast< int >( parent ) ].children.append( self );
     }
 
-    parent = c++;
     if ( item.canConvert< QVariantList >() )
     {
+        int row = 0;
         for ( const auto& subitem : item.toList() )
         {
-            overallLength( subitem, c, parent, skiplist );
+            addNodes( subitem, row++, self, nodes );
         }
     }
     else if ( item.canConvert< QVariantMap >() )
     {
-        for ( const auto& subitem : item.toMap() )
+        const QVariantMap map = item.toMap();
+        for ( auto it = map.cbegin(); it != map.cend(); ++it )
         {
-            overallLength( subitem, c, parent, skiplist );
+            addNodes( it.value(), it.key(), self, nodes );
         }
     }
 }
 
-static quintptr
-findNth( const VariantModel::IndexVector& skiplist, quintptr value, int n )
+/// @brief Do @p a and @p b have the same tree-shape (and keys)?
+static bool
+sameShape( const VariantModel::NodeVector& a, const VariantModel::NodeVector& b )
 {
-    constexpr const quintptr invalid_index = static_cast< quintptr >( -1 );
-
-    if ( n < 0 )
+    if ( a.count() != b.count() )
     {
-        return invalid_index;
+        return false;
     }
-
-    int index = static_cast< int >( value );
-    while ( ( n >= 0 ) && ( index < skiplist.count() ) )
+    for ( int i = 0; i < a.count(); ++i )
     {
-        if ( skiplist[ index ] == value )
+        if ( a[ i ].parent != b[ i ].parent || a[ i ].key != b[ i ].key )
         {
-            if ( --n < 0 )
-            {
-                // It's bigger than 0
-                return static_cast< quintptr >( index );
-            }
+            return false;
         }
-        index++;
     }
-    return invalid_index;
+    return true;
 }
 
 
 VariantModel::VariantModel( const QVariant* p )
     : m_p( p )
 {
-    reload();
+    addNodes( *m_p, QVariant(), invalid_index, m_nodes );
 }
 
 VariantModel::~VariantModel() {}
@@ -81,15 +89,30 @@ VariantModel::~VariantModel() {}
 void
 VariantModel::reload()
 {
-    constexpr const quintptr invalid_index = static_cast< quintptr >( -1 );
+    NodeVector nodes;
+    nodes.reserve( std::max( m_nodes.count(), 64 ) );  // Usually about as big as before
+    addNodes( *m_p, QVariant(), invalid_index, nodes );
+
+    if ( !sameShape( m_nodes, nodes ) )
+    {
+        beginResetModel();
+        m_nodes.swap( nodes );
+        endResetModel();
+        return;
+    }
 
-    quintptr x = 0;
-    m_rows.clear();  // Start over
-    if ( m_rows.capacity() < 64 )
+    // Same tree, so the indexes stay valid; only the (leaf) values may
+    // have changed. Containers show no value of their own.
+    m_nodes.swap( nodes );
+    for ( int i = 1; i < m_nodes.count(); ++i )
     {
-        m_rows.reserve( 64 );  // Start reasonably-sized
+        const Node& node = m_nodes[ i ];
+        if ( node.children.isEmpty() && node.value != nodes[ i ].value )
+        {
+            const QModelIndex changed = createIndex( node.row, 1, static_cast< quintptr >( i ) );
+            emit dataChanged( changed, changed, { Qt::DisplayRole } );
+        }
     }
-    overallLength( *m_p, x, invalid_index, &m_rows );
 }
 
 int
@@ -101,8 +124,12 @@ VariantModel::columnCount( const QModelIndex& ) const
 int
 VariantModel::rowCount( const QModelIndex& index ) const
 {
+    if ( index.isValid() && index.column() != 0 )
+    {
+        return 0;
+    }
     quintptr p = index.isValid() ? index.internalId() : 0;
-    return m_rows.count( p );
+    return inRange( p ) ? m_nodes[ static_cast< int >( p ) ].children.count() : 0;
 }
 
 QModelIndex
@@ -112,19 +139,19 @@ VariantModel::index( int row, int column, const QModelIndex& parent ) const
 
     if ( parent.isValid() )
     {
-        if ( inRange( parent ) )
+        if ( !inRange( parent ) )
         {
-            p = parent.internalId();
+            return QModelIndex();
         }
+        p = parent.internalId();
     }
 
-    return createIndex( row, column, findNth( m_rows, p, row ) );
-}
-
-static inline quintptr
-deref( const VariantModel::IndexVector& v, quintptr i )
-{
-    return v[ static_cast< int >( i ) ];
+    const auto& children = m_nodes[ static_cast< int >( p ) ].children;
+    if ( row < 0 || row >= children.count() || column < 0 || column > 1 )
+    {
+        return QModelIndex();
+    }
+    return createIndex( row, column, children[ row ] );
 }
 
 QModelIndex
@@ -135,27 +162,13 @@ VariantModel::parent( const QModelIndex& index ) const
         return QModelIndex();
     }
 
-    quintptr p = deref( m_rows, index.internalId() );
-    if ( p == 0 )
+    quintptr p = m_nodes[ static_cast< int >( index.internalId() ) ].parent;
+    if ( p == 0 || !inRange( p ) )
     {
         return QModelIndex();
     }
 
-    if ( !inRange( p ) )
-    {
-        return QModelIndex();
-    }
-    quintptr p_pid = deref( m_rows, p );
-    int row = 0;
-    for ( int i = static_cast< int >( p_pid ); i < static_cast< int >( p ); ++i )
-    {
-        if ( m_rows[ i ] == p_pid )
-        {
-            row++;
-        }
-    }
-
-    return createIndex( row, index.column(), p );
+    return createIndex( m_nodes[ static_cast< int >( p ) ].row, 0, p );
 }
 
 QVariant
@@ -181,49 +194,8 @@ VariantModel::data( const QModelIndex& index, int role ) const
         return QVariant();
     }
 
-    const QVariant thing = underlying( parent( index ) );
-
-    if ( !thing.isValid() )
-    {
-        return QVariant();
-    }
-
-    if ( thing.canConvert< QVariantMap >() )
-    {
-        QVariantMap the_map = thing.toMap();
-        const auto key = the_map.keys().at( index.row() );
-        if ( index.column() == 0 )
-        {
-            return key;
-        }
-        else
-        {
-            return the_map[ key ];
-        }
-    }
-    else if ( thing.canConvert< QVariantList >() )
-    {
-        if ( index.column() == 0 )
-        {
-            return index.row();
-        }
-        else
-        {
-            QVariantList the_list = thing.toList();
-            return the_list.at( index.row() );
-        }
-    }
-    else
-    {
-        if ( index.column() == 0 )
-        {
-            return QVariant();
-        }
-        else
-        {
-            return thing;
-        }
-    }
+    const Node& node = m_nodes[ static_cast< int >( index.internalId() ) ];
+    return index.column() == 0 ? node.key : node.value;
 }
 
 QVariant
@@ -254,27 +226,3 @@ VariantModel::headerData( int section, Qt::Orientation orientation, int role ) c
         return QVariant();
     }
 }
-
-const QVariant
-VariantModel::underlying( const QModelIndex& index ) const
-{
-    if ( !index.isValid() )
-    {
-        return *m_p;
-    }
-
-    const auto& thing = underlying( parent( index ) );
-    if ( thing.canConvert< QVariantMap >() )
-    {
-        const auto& the_map = thing.toMap();
-        return the_map[ the_map.keys()[ index.row() ] ];
-    }
-    else if ( thing.canConvert< QVariantList >() )
-    {
-        return thing.toList()[ index.row() ];
-    }
-    else
-    {
-        return thing;
-    }
-}
@@ -36,6 +36,10 @@
  * QVariant does not change during use. If the QVariant
  * **does** change, call reload() to re-build the internal
  * representation of the tree.
+ *
+ * The model keeps a copy of the (implicitly shared) values
+ * in the tree, so it does not need to walk the variant to
+ * look up data.
  */
 class VariantModel : public QAbstractItemModel
 {
@@ -48,6 +52,22 @@ public:
      */
     using IndexVector = QVector< quintptr >;
 
+    /** @brief One node of the tree
+     *
+     * The node at index 0 is the root (the variant itself); every
+     * other node knows its parent, its row in the parent, and
+     * its own children, so navigating the tree is a lookup.
+     */
+    struct Node
+    {
+        quintptr parent;
+        int row;
+        QVariant key;  ///< Key in the map, or index in the list
+        QVariant value;
+        IndexVector children;
+    };
+    using NodeVector = QVector< Node >;
+
     /** @brief Constructor
      *
      * The QVariant's lifetime is **not** affected by the model,
@@ -61,7 +81,10 @@ public:
     /** @brief Re-build the internal tree
      *
      * Call this when the underlying variant is changed, which
-     * might impact how the tree is laid out.
+     * might impact how the tree is laid out. If the shape of the
+     * tree (and all the keys) are unchanged, only dataChanged()
+     * is emitted for the values that changed; otherwise the model
+     * is reset.
      */
     void reload();
 
@@ -74,38 +97,24 @@ public:
     QVariant headerData( int section, Qt::Orientation orientation, int role ) const override;
 
 private:
+    static constexpr const quintptr invalid_index = static_cast< quintptr >( -1 );
+
     const QVariant* const m_p;
 
     /** @brief Tree representation of the variant.
      *
-     * At index 0 in the vector , we store -1 to indicate the root.
+     * At index 0 in the vector, we store the root, with parent -1.
      *
      * Then we enumerate all the elements in the tree (by traversing
      * the variant and using QVariantMap and QVariantList as having
-     * children, and everything else being a leaf node) and at the index
-     * for a child, store the index of its parent. This means that direct
-     * children of the root store a 0 in their indexes, children of the first
-     * child of the root store a 1, and we can "pointer chase" from an index
-     * through parents back to index 0.
-     *
-     * Because of this structure, the value stored at index i must be
-     * less than i (except for index 0, which is special). This makes it
-     * slightly easier to search for a given value *p*, because we can start
-     * at index *p* (or even *p+1*).
-     *
-     * Given an index *i* into the vector corresponding to a child, we know the
-     * parent, but can also count which row this child should have, by counting
-     * *other* indexes before *i* with the same parent (and by the ordering
-     * of values, we can start counting at index *parent-index*).
-     *
+     * children, and everything else being a leaf node) in depth-first
+     * order. The internal id of a QModelIndex is the index of its
+     * node in this vector.
      */
-    IndexVector m_rows;
-
-    /// @brief Implementation of walking an index through the variant-tree
-    const QVariant underlying( const QModelIndex& index ) const;
+    NodeVector m_nodes;
 
     /// @brief Helpers for range-checking
-    inline bool inRange( quintptr p ) const { return p < static_cast< quintptr >( m_rows.count() ); }
+    inline bool inRange( quintptr p ) const { return p < static_cast< quintptr >( m_nodes.count() ); }
     inline bool inRange( const QModelIndex& index ) const { return inRange( index.internalId() ); }
 };
 
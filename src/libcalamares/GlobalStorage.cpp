@@ -25,6 +25,7 @@
 #include "utils/Yaml.h"
 
 #include <QFile>
+#include <QHash>
 #include <QJsonDocument>
 
 #ifdef WITH_PYTHON
@@ -67,6 +68,7 @@ void
 GlobalStorage::insert( const QString& key, const QVariant& value )
 {
     m.insert( key, value );
+    ++m_revision;
     emit changed();
 }
 
@@ -82,6 +84,7 @@ int
 GlobalStorage::remove( const QString& key )
 {
     int nItems = m.remove( key );
+    ++m_revision;
     emit changed();
     return nItems;
 }
@@ -175,6 +178,22 @@ namespace CalamaresPython
 
 Calamares::GlobalStorage* GlobalStoragePythonWrapper::s_gs_instance = nullptr;
 
+struct GlobalStoragePythonWrapper::ValueCache
+{
+    quint64 revision = 0;
+    QHash< QString, bp::object > values;
+
+    /// @brief Drops everything if @p gs has been modified since last time
+    void sync( const Calamares::GlobalStorage* gs )
+    {
+        if ( gs->revision() != revision )
+        {
+            values.clear();
+            revision = gs->revision();
+        }
+    }
+};
+
 // The special handling for nullptr is only for the testing
 // script for the python bindings, which passes in None;
 // normal use will have a GlobalStorage from JobQueue::instance()
@@ -182,6 +201,7 @@ Calamares::GlobalStorage* GlobalStoragePythonWrapper::s_gs_instance = nullptr;
 // object, but that's OK for testing.
 GlobalStoragePythonWrapper::GlobalStoragePythonWrapper( Calamares::GlobalStorage* gs )
     : m_gs( gs ? gs : s_gs_instance )
+    , m_cache( std::make_shared< ValueCache >() )
 {
     if ( !m_gs )
     {
@@ -207,7 +227,12 @@ GlobalStoragePythonWrapper::count() const
 void
 GlobalStoragePythonWrapper::insert( const std::string& key, const bp::object& value )
 {
-    m_gs->insert( QString::fromStdString( key ), CalamaresPython::variantFromPyObject( value ) );
+    const QString k = QString::fromStdString( key );
+    m_cache->sync( m_gs );
+    m_gs->insert( k, CalamaresPython::variantFromPyObject( value ) );
+    // Only this key is stale, keep the rest
+    m_cache->values.remove( k );
+    m_cache->revision = m_gs->revision();
 }
 
 bp::list
@@ -226,14 +251,28 @@ GlobalStoragePythonWrapper::keys() const
 int
 GlobalStoragePythonWrapper::remove( const std::string& key )
 {
-    return m_gs->remove( QString::fromStdString( key ) );
+    const QString k = QString::fromStdString( key );
+    m_cache->sync( m_gs );
+    int nItems = m_gs->remove( k );
+    m_cache->values.remove( k );
+    m_cache->revision = m_gs->revision();
+    return nItems;
 }
 
 
 bp::object
 GlobalStoragePythonWrapper::value( const std::string& key ) const
 {
-    return CalamaresPython::variantToPyObject( m_gs->value( QString::fromStdString( key ) ) );
+    const QString k = QString::fromStdString( key );
+    m_cache->sync( m_gs );
+    auto it = m_cache->values.constFind( k );
+    if ( it != m_cache->values.constEnd() )
+    {
+        return *it;
+    }
+    bp::object v = CalamaresPython::variantToPyObject( m_gs->value( k ) );
+    m_cache->values.insert( k, v );
+    return v;
 }
 
 }  // namespace CalamaresPython
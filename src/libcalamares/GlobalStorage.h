@@ -27,6 +27,8 @@
 #include <QVariantMap>
 
 #ifdef WITH_PYTHON
+#include <memory>
+
 namespace boost
 {
 namespace python
@@ -97,11 +99,19 @@ public:
      */
     const QVariantMap& data() const { return m; }
 
+    /** @brief Counter that changes on every modification
+     *
+     * This is cheaper than listening to changed() for
+     * code that only needs to know if it has a stale copy.
+     */
+    quint64 revision() const { return m_revision; }
+
 signals:
     void changed();
 
 private:
     QVariantMap m;
+    quint64 m_revision = 0;
 };
 
 }  // namespace Calamares
@@ -128,7 +138,21 @@ public:
     static Calamares::GlobalStorage* globalStorageInstance() { return s_gs_instance; }
 
 private:
+    /** @brief Python objects already converted by value()
+     *
+     * Converting (for instance) the list of partitions is expensive,
+     * and scripts may read it many times. The cache is dropped when
+     * the GlobalStorage changes; inserting through this wrapper only
+     * drops the key that was inserted.
+     *
+     * Note that this means that value() returns the same Python
+     * object each time, so modifying it in-place is visible to
+     * later calls to value() (until the key is inserted again).
+     */
+    struct ValueCache;
+
     Calamares::GlobalStorage* m_gs;
+    std::shared_ptr< ValueCache > m_cache;
     static Calamares::GlobalStorage* s_gs_instance;  // See globalStorageInstance()
 };
 
@@ -2,6 +2,7 @@
  *
  *   Copyright 2014-2015, Teo Mrnjavac <teo@kde.org>
  *   Copyright 2018, Adriaan de Groot <groot@kde.org>
+ *   Copyright 2026, agent <agent@local>
  *
  *   Calamares is free software: you can redistribute it and/or modify
  *   it under the terms of the GNU General Public License as published by
@@ -21,6 +22,7 @@
 
 #include "GlobalStorage.h"
 #include "Job.h"
+#include "utils/CalamaresUtilsSystem.h"
 #include "utils/Logger.h"
 
 #include "CalamaresConfig.h"
@@ -28,11 +30,33 @@
 #include "PythonHelper.h"
 #endif
 
+#include <QFuture>
+#include <QMutex>
 #include <QThread>
+#include <QtConcurrent/QtConcurrent>
 
 namespace Calamares
 {
 
+/** @brief The outcome of background work
+ *
+ * JobResult can't be copied, which QFuture needs, so this
+ * keeps the parts of it that are reported.
+ */
+struct BackgroundResult
+{
+    bool ok = true;
+    QString message;
+    QString details;
+};
+
+struct BackgroundWork
+{
+    QString name;
+    QStringList joinBefore;
+    QFuture< BackgroundResult > result;
+};
+
 class JobThread : public QThread
 {
 public:
@@ -45,9 +69,10 @@ public:
 
     virtual ~JobThread() override;
 
-    void setJobs( const JobList& jobs )
+    void setJobs( const JobList& jobs, const QStringList& moduleNames )
     {
         m_jobs = jobs;
+        m_jobModules = moduleNames;
 
         qreal totalJobsWeight = 0.0;
         for ( auto job : m_jobs )
@@ -68,18 +93,38 @@ public:
         QString details;
 
         m_jobIndex = 0;
-        for ( auto job : m_jobs )
+        for ( int index = 0; index < m_jobs.count(); ++index )
         {
+            const auto& job = m_jobs.at( index );
+            const QString& moduleName = m_jobModules.at( index );
             if ( anyFailed && !job->isEmergency() )
             {
                 cDebug() << "Skipping non-emergency job" << job->prettyName();
                 continue;
             }
+            // Background work that this module relies on must be done first
+            if ( !moduleName.isEmpty()
+                 && !joinBackground( [&moduleName]( const BackgroundWork& w ) {
+                        return w.joinBefore.contains( moduleName );
+                    } )
+                 && !anyFailed )
+            {
+                anyFailed = true;
+                message = m_backgroundMessage;
+                details = m_backgroundDetails;
+                if ( !job->isEmergency() )
+                {
+                    cDebug() << "Skipping non-emergency job" << job->prettyName();
+                    continue;
+                }
+            }
 
             emitProgress();
             cDebug() << "Starting" << ( anyFailed ? "EMERGENCY JOB" : "job" ) << job->prettyName();
             connect( job.data(), &Job::progress, this, &JobThread::emitProgress );
             JobResult result = job->exec();
+            // Don't keep the target busy between jobs (e.g. for umount)
+            CalamaresUtils::System::closeTargetSession();
             if ( !anyFailed && !result )
             {
                 anyFailed = true;
@@ -91,6 +136,13 @@ public:
                 ++m_jobIndex;
             }
         }
+        // Nothing may be left running once the queue is done
+        if ( !joinBackground( []( const BackgroundWork& ) { return true; } ) && !anyFailed )
+        {
+            anyFailed = true;
+            message = m_backgroundMessage;
+            details = m_backgroundDetails;
+        }
         if ( anyFailed )
         {
             emitFailed( message, details );
@@ -102,12 +154,78 @@ public:
         emitFinished();
     }
 
+    void startBackground( const QString& name,
+                          const QStringList& joinBefore,
+                          const std::function< JobResult() >& work )
+    {
+        cDebug() << "Starting background work" << name << "to finish before" << joinBefore;
+        auto result = QtConcurrent::run( [work]() {
+            JobResult r = work();
+            // Don't keep the target busy from a pool thread
+            CalamaresUtils::System::closeTargetSession();
+            return BackgroundResult { bool( r ), r.message(), r.details() };
+        } );
+        QMutexLocker lock( &m_backgroundMutex );
+        m_background.append( BackgroundWork { name, joinBefore, result } );
+    }
+
 private:
     JobList m_jobs;
+    QStringList m_jobModules;
     QList< qreal > m_jobWeights;
     JobQueue* m_queue;
     int m_jobIndex;
 
+    QMutex m_backgroundMutex;
+    QList< BackgroundWork > m_background;
+    QString m_backgroundMessage;
+    QString m_backgroundDetails;
+
+    /** @brief Wait for the background work selected by @p join
+     *
+     * All of the selected work is waited for, even if some of it
+     * fails. Returns false if any of it failed, and then the message
+     * and details of the first failure are kept in m_backgroundMessage
+     * and m_backgroundDetails.
+     */
+    bool joinBackground( const std::function< bool( const BackgroundWork& ) >& join )
+    {
+        QList< BackgroundWork > joined;
+        {
+            QMutexLocker lock( &m_backgroundMutex );
+            for ( auto it = m_background.begin(); it != m_background.end(); )
+            {
+                if ( join( *it ) )
+                {
+                    joined.append( *it );
+                    it = m_background.erase( it );
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+        }
+
+        bool ok = true;
+        for ( const auto& w : joined )
+        {
+            cDebug() << "Waiting for background work" << w.name;
+            const BackgroundResult r = w.result.result();
+            if ( !r.ok )
+            {
+                cWarning() << "Background work" << w.name << "failed:" << r.message;
+                if ( ok )
+                {
+                    m_backgroundMessage = r.message;
+                    m_backgroundDetails = r.details;
+                }
+                ok = false;
+            }
+        }
+        return ok;
+    }
+
     void emitProgress( qreal jobPercent = 0 )
     {
         // Make sure jobPercent is reasonable, in case a job messed up its
@@ -197,8 +315,9 @@ void
 JobQueue::start()
 {
     Q_ASSERT( !m_thread->isRunning() );
-    m_thread->setJobs( m_jobs );
+    m_thread->setJobs( m_jobs, m_jobModules );
     m_jobs.clear();
+    m_jobModules.clear();
     m_thread->start();
 }
 
@@ -208,16 +327,38 @@ JobQueue::enqueue( const job_ptr& job )
 {
     Q_ASSERT( !m_thread->isRunning() );
     m_jobs.append( job );
+    m_jobModules.append( QString() );
     emit queueChanged( m_jobs );
 }
 
 
 void
 JobQueue::enqueue( const JobList& jobs )
+{
+    Q_ASSERT( !m_thread->isRunning() );
+    enqueue( QString(), jobs );
+}
+
+
+void
+JobQueue::enqueue( const QString& moduleName, const JobList& jobs )
 {
     Q_ASSERT( !m_thread->isRunning() );
     m_jobs.append( jobs );
+    for ( int i = 0; i < jobs.count(); ++i )
+    {
+        m_jobModules.append( moduleName );
+    }
     emit queueChanged( m_jobs );
 }
 
+
+void
+JobQueue::startBackground( const QString& name,
+                           const QStringList& joinBefore,
+                           const std::function< JobResult() >& work )
+{
+    m_thread->startBackground( name, joinBefore, work );
+}
+
 }  // namespace Calamares
@@ -1,6 +1,7 @@
 /* === This file is part of Calamares - <https://github.com/calamares> ===
  *
  *   Copyright 2014-2015, Teo Mrnjavac <teo@kde.org>
+ *   Copyright 2026, agent <agent@local>
  *
  *   Calamares is free software: you can redistribute it and/or modify
  *   it under the terms of the GNU General Public License as published by
@@ -23,6 +24,9 @@
 #include "Job.h"
 
 #include <QObject>
+#include <QStringList>
+
+#include <functional>
 
 namespace Calamares
 {
@@ -43,8 +47,31 @@ public:
 
     void enqueue( const job_ptr& job );
     void enqueue( const JobList& jobs );
+    /** @brief Enqueue the @p jobs of the module named @p moduleName
+     *
+     * The module name is used to find the join points of background
+     * work, see startBackground().
+     */
+    void enqueue( const QString& moduleName, const JobList& jobs );
     void start();
 
+    /** @brief Run @p work alongside the rest of the queue
+     *
+     * This is meant to be called from a job's exec(), so that the job
+     * can return right away while @p work (e.g. a slow command) runs in
+     * a thread of its own. The queue waits for @p work to finish before
+     * it runs the jobs of any module named in @p joinBefore, and at the
+     * end of the queue. If @p work fails, the queue fails at that point,
+     * with the message and details of its result.
+     *
+     * Jobs keep running (and changing global storage) while @p work
+     * runs, so @p work must not use global storage; look up what it
+     * needs beforehand, e.g. with System::targetEnvCommandLine().
+     */
+    void startBackground( const QString& name,
+                          const QStringList& joinBefore,
+                          const std::function< JobResult() >& work );
+
 signals:
     void queueChanged( const JobList& jobs );
     void progress( qreal percent, const QString& prettyName );
@@ -55,6 +82,7 @@ private:
     static JobQueue* s_instance;
 
     JobList m_jobs;
+    QStringList m_jobModules;  // Module name for each of m_jobs
     JobThread* m_thread;
     GlobalStorage* m_storage;
 };
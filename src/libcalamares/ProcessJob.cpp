@@ -65,16 +65,21 @@ ProcessJob::exec()
 {
     using CalamaresUtils::System;
 
+    // Streamed, so that output is logged while the command runs,
+    // and only the last of it is kept to explain a failure.
+    auto output = []( const QString& ) {};
+
     if ( m_runInChroot )
         return CalamaresUtils::System::instance()
-            ->targetEnvCommand( { m_command }, m_workingPath, QString(), m_timeoutSec )
+            ->targetEnvCommand( { m_command }, m_workingPath, QString(), m_timeoutSec, output )
             .explainProcess( m_command, m_timeoutSec );
     else
         return System::runCommand( System::RunLocation::RunInHost,
                                    { "/bin/sh", "-c", m_command },
                                    m_workingPath,
                                    QString(),
-                                   m_timeoutSec )
+                                   m_timeoutSec,
+                                   output )
             .explainProcess( m_command, m_timeoutSec );
 }
 
@@ -23,8 +23,11 @@
 #include "utils/Logger.h"
 
 #include <QDir>
+#include <QFile>
 #include <QFileInfo>
 
+#include <limits>
+
 #undef slots
 #include <boost/python.hpp>
 
@@ -34,6 +37,86 @@ namespace CalamaresPython
 {
 
 
+/// @brief Wraps a borrowed reference @p p in a boost::python object
+static inline bp::object
+borrowed( PyObject* p )
+{
+    return bp::object( bp::handle<>( bp::borrowed( p ) ) );
+}
+
+/// @brief Converts a Python string object @p p (which must be a str) to QString
+static inline QString
+stringFromPyUnicode( PyObject* p )
+{
+    Py_ssize_t size = 0;
+    const char* utf8 = PyUnicode_AsUTF8AndSize( p, &size );
+    if ( !utf8 )
+    {
+        PyErr_Clear();
+        return QString();
+    }
+    return QString::fromUtf8( utf8, int( size ) );
+}
+
+/// @brief Converts each item of the sequence or set @p p
+static QVariantList
+variantListFromIterable( PyObject* p )
+{
+    QVariantList list;
+    if ( PyList_Check( p ) || PyTuple_Check( p ) )
+    {
+        // Fast path, index directly with borrowed references
+        const Py_ssize_t size = PySequence_Fast_GET_SIZE( p );
+        PyObject** items = PySequence_Fast_ITEMS( p );
+        list.reserve( int( size ) );
+        for ( Py_ssize_t i = 0; i < size; ++i )
+        {
+            list.append( variantFromPyObject( borrowed( items[ i ] ) ) );
+        }
+    }
+    else
+    {
+        bp::handle<> it( PyObject_GetIter( p ) );
+        while ( PyObject* item = PyIter_Next( it.get() ) )
+        {
+            list.append( variantFromPyObject( bp::object( bp::handle<>( item ) ) ) );
+        }
+        if ( PyErr_Occurred() )
+        {
+            bp::throw_error_already_set();
+        }
+    }
+    return list;
+}
+
+/** @brief Calls @p insert( key, value ) for each item of the dict
+ *
+ * Keys that are not strings are skipped. Iterating with PyDict_Next
+ * avoids building a list of keys and looking up each one again.
+ */
+template < typename F >
+static void
+forEachPyDictItem( PyObject* pyDict, F insert )
+{
+    PyObject* key = nullptr;
+    PyObject* value = nullptr;
+    Py_ssize_t pos = 0;
+    bool warned = false;
+    while ( PyDict_Next( pyDict, &pos, &key, &value ) )
+    {
+        if ( !PyUnicode_Check( key ) )
+        {
+            if ( !warned )
+            {
+                cDebug() << "Key invalid, map might be incomplete.";
+                warned = true;
+            }
+            continue;
+        }
+        insert( stringFromPyUnicode( key ), variantFromPyObject( borrowed( value ) ) );
+    }
+}
+
 boost::python::object
 variantToPyObject( const QVariant& variant )
 {
@@ -52,14 +135,29 @@ variantToPyObject( const QVariant& variant )
     case QVariant::Int:
         return bp::object( variant.toInt() );
 
+    case QVariant::UInt:
+        return bp::object( variant.toUInt() );
+
     case QVariant::LongLong:
         return bp::object( variant.toLongLong() );
 
+    case QVariant::ULongLong:
+        return bp::object( variant.toULongLong() );
+
     case QVariant::Double:
         return bp::object( variant.toDouble() );
 
     case QVariant::String:
-        return bp::object( variant.toString().toStdString() );
+    {
+        const QByteArray utf8 = variant.toString().toUtf8();
+        return bp::object( bp::handle<>( PyUnicode_FromStringAndSize( utf8.constData(), utf8.size() ) ) );
+    }
+
+    case QVariant::ByteArray:
+    {
+        const QByteArray bytes = variant.toByteArray();
+        return bp::object( bp::handle<>( PyBytes_FromStringAndSize( bytes.constData(), bytes.size() ) ) );
+    }
 
     case QVariant::Bool:
         return bp::object( variant.toBool() );
@@ -73,37 +171,55 @@ variantToPyObject( const QVariant& variant )
 QVariant
 variantFromPyObject( const boost::python::object& pyObject )
 {
-    std::string pyType = bp::extract< std::string >( pyObject.attr( "__class__" ).attr( "__name__" ) );
-    if ( pyType == "dict" )
+    // Dispatch on the type object, rather than on the name of the class;
+    // this also accepts subclasses (e.g. OrderedDict). Note that bool is
+    // a subclass of int, so it must be checked first.
+    PyObject* p = pyObject.ptr();
+    if ( p == Py_None )
     {
-        return variantMapFromPyDict( bp::extract< bp::dict >( pyObject ) );
+        return QVariant();
     }
-
-    else if ( pyType == "list" )
+    else if ( PyBool_Check( p ) )
     {
-        return variantListFromPyList( bp::extract< bp::list >( pyObject ) );
+        return QVariant( p == Py_True );
     }
-
-    else if ( pyType == "int" )
+    else if ( PyLong_Check( p ) )
     {
-        return QVariant( bp::extract< int >( pyObject ) );
+        int overflow = 0;
+        const long long v = PyLong_AsLongLongAndOverflow( p, &overflow );
+        if ( overflow )
+        {
+            cWarning() << "Python integer too large, using 0.";
+            return QVariant( 0 );
+        }
+        if ( v >= std::numeric_limits< int >::min() && v <= std::numeric_limits< int >::max() )
+        {
+            return QVariant( int( v ) );
+        }
+        return QVariant( v );
     }
-
-    else if ( pyType == "float" )
+    else if ( PyFloat_Check( p ) )
     {
-        return QVariant( bp::extract< double >( pyObject ) );
+        return QVariant( PyFloat_AS_DOUBLE( p ) );
     }
-
-    else if ( pyType == "str" )
+    else if ( PyUnicode_Check( p ) )
     {
-        return QVariant( QString::fromStdString( bp::extract< std::string >( pyObject ) ) );
+        return QVariant( stringFromPyUnicode( p ) );
     }
-
-    else if ( pyType == "bool" )
+    else if ( PyDict_Check( p ) )
     {
-        return QVariant( bp::extract< bool >( pyObject ) );
+        QVariantMap map;
+        forEachPyDictItem( p, [&map]( const QString& k, const QVariant& v ) { map.insert( k, v ); } );
+        return map;
+    }
+    else if ( PyList_Check( p ) || PyTuple_Check( p ) || PyAnySet_Check( p ) )
+    {
+        return variantListFromIterable( p );
+    }
+    else if ( PyBytes_Check( p ) )
+    {
+        return QVariant( QByteArray( PyBytes_AS_STRING( p ), int( PyBytes_GET_SIZE( p ) ) ) );
     }
-
     else
     {
         return QVariant();
@@ -126,12 +242,7 @@ variantListToPyList( const QVariantList& variantList )
 QVariantList
 variantListFromPyList( const boost::python::list& pyList )
 {
-    QVariantList list;
-    for ( int i = 0; i < bp::len( pyList ); ++i )
-    {
-        list.append( variantFromPyObject( pyList[ i ] ) );
-    }
-    return list;
+    return variantListFromIterable( pyList.ptr() );
 }
 
 
@@ -146,27 +257,11 @@ variantMapToPyDict( const QVariantMap& variantMap )
     return pyDict;
 }
 
-
 QVariantMap
 variantMapFromPyDict( const boost::python::dict& pyDict )
 {
     QVariantMap map;
-    bp::list keys = pyDict.keys();
-    for ( int i = 0; i < bp::len( keys ); ++i )
-    {
-        bp::extract< std::string > extracted_key( keys[ i ] );
-        if ( !extracted_key.check() )
-        {
-            cDebug() << "Key invalid, map might be incomplete.";
-            continue;
-        }
-
-        std::string key = extracted_key;
-
-        bp::object obj = pyDict[ key ];
-
-        map.insert( QString::fromStdString( key ), variantFromPyObject( obj ) );
-    }
+    forEachPyDictItem( pyDict.ptr(), [&map]( const QString& k, const QVariant& v ) { map.insert( k, v ); } );
     return map;
 }
 
@@ -186,22 +281,8 @@ QVariantHash
 variantHashFromPyDict( const boost::python::dict& pyDict )
 {
     QVariantHash hash;
-    bp::list keys = pyDict.keys();
-    for ( int i = 0; i < bp::len( keys ); ++i )
-    {
-        bp::extract< std::string > extracted_key( keys[ i ] );
-        if ( !extracted_key.check() )
-        {
-            cDebug() << "Key invalid, map might be incomplete.";
-            continue;
-        }
-
-        std::string key = extracted_key;
-
-        bp::object obj = pyDict[ key ];
-
-        hash.insert( QString::fromStdString( key ), variantFromPyObject( obj ) );
-    }
+    hash.reserve( int( bp::len( pyDict ) ) );
+    forEachPyDictItem( pyDict.ptr(), [&hash]( const QString& k, const QVariant& v ) { hash.insert( k, v ); } );
     return hash;
 }
 
@@ -232,8 +313,16 @@ Helper::Helper( QObject* parent )
         if ( !Py_IsInitialized() )
         {
             Py_Initialize();
+#if PY_VERSION_HEX < 0x03070000
+            PyEval_InitThreads();
+#endif
+            // Py_Initialize() leaves this thread holding the GIL. Python is
+            // used from more than one thread (see prewarm()), so drop it here;
+            // from now on, everyone takes it with a GILLock.
+            PyEval_SaveThread();
         }
 
+        GILLock lock;
         m_mainModule = bp::import( "__main__" );
         m_mainNamespace = m_mainModule.attr( "__dict__" );
 
@@ -278,6 +367,71 @@ Helper::createCleanNamespace()
 }
 
 
+boost::python::object
+Helper::compile( const QString& path )
+{
+    QFileInfo fi( path );
+    auto it = m_compiled.constFind( path );
+    if ( it != m_compiled.constEnd() && it->modified == fi.lastModified() && it->size == fi.size() )
+    {
+        return it->code;
+    }
+
+    QFile scriptFile( path );
+    if ( !scriptFile.open( QIODevice::ReadOnly ) )
+    {
+        PyErr_SetString( PyExc_IOError, QString( "Cannot read %1" ).arg( path ).toUtf8().constData() );
+        bp::throw_error_already_set();
+    }
+    const QByteArray source = scriptFile.readAll();
+    PyObject* code = Py_CompileString( source.constData(), path.toLocal8Bit().constData(), Py_file_input );
+    if ( !code )
+    {
+        bp::throw_error_already_set();
+    }
+
+    bp::object codeObject { bp::handle<>( code ) };
+    m_compiled.insert( path, CompiledScript { fi.lastModified(), fi.size(), codeObject } );
+    return codeObject;
+}
+
+
+void
+Helper::prewarm( const QString& path )
+{
+    if ( !m_prewarmedImports )
+    {
+        // The modules commonly imported by Calamares job modules
+        static const char* const modules[]
+            = { "libcalamares", "os", "re", "shutil", "subprocess", "gettext", "glob", "tempfile" };
+        for ( const char* name : modules )
+        {
+            try
+            {
+                bp::import( name );
+            }
+            catch ( bp::error_already_set& )
+            {
+                PyErr_Clear();
+                cWarning() << "Could not import Python module" << name;
+            }
+        }
+        m_prewarmedImports = true;
+    }
+
+    try
+    {
+        compile( path );
+        cDebug() << "Python script" << path << "compiled.";
+    }
+    catch ( bp::error_already_set& )
+    {
+        PyErr_Clear();
+        cWarning() << "Python script" << path << "does not compile.";
+    }
+}
+
+
 QString
 Helper::handleLastError()
 {
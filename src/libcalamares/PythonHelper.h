@@ -22,6 +22,8 @@
 
 #include "PythonJob.h"
 
+#include <QDateTime>
+#include <QHash>
 #include <QStringList>
 
 #undef slots
@@ -45,6 +47,28 @@ boost::python::dict variantHashToPyDict( const QVariantHash& variantHash );
 QVariantHash variantHashFromPyDict( const boost::python::dict& pyDict );
 
 
+/** @brief Holds the Python GIL for the lifetime of this object
+ *
+ * The interpreter is shared between the job thread and the
+ * thread that prepares scripts (see Helper::prewarm()), so
+ * any code that uses Python objects must hold the GIL.
+ */
+class GILLock
+{
+public:
+    GILLock()
+        : m_state( PyGILState_Ensure() )
+    {
+    }
+    ~GILLock() { PyGILState_Release( m_state ); }
+
+    GILLock( const GILLock& ) = delete;
+    GILLock& operator=( const GILLock& ) = delete;
+
+private:
+    PyGILState_STATE m_state;
+};
+
 class Helper : public QObject
 {
     Q_OBJECT
@@ -55,6 +79,23 @@ public:
 
     QString handleLastError();
 
+    /** @brief Compiled code for the script at @p path
+     *
+     * The code object is cached, and compiled again only if
+     * the file has changed. Throws error_already_set if the
+     * script cannot be compiled. Call this with the GIL held.
+     */
+    boost::python::object compile( const QString& path );
+
+    /** @brief Compile the script at @p path ahead of time
+     *
+     * Also imports the standard-library modules that job modules
+     * commonly use; once imported, they are shared by all the jobs.
+     * Errors are logged, and will be reported by the job itself
+     * when it runs. Call this with the GIL held.
+     */
+    void prewarm( const QString& path );
+
 private:
     friend Helper* Calamares::PythonJob::helper();
     explicit Helper( QObject* parent = nullptr );
@@ -64,6 +105,15 @@ private:
     boost::python::object m_mainNamespace;
 
     QStringList m_pythonPaths;
+
+    struct CompiledScript
+    {
+        QDateTime modified;
+        qint64 size;
+        boost::python::object code;
+    };
+    QHash< QString, CompiledScript > m_compiled;
+    bool m_prewarmedImports = false;
 };
 
 }  // namespace CalamaresPython
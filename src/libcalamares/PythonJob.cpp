@@ -25,6 +25,9 @@
 #include "utils/Logger.h"
 
 #include <QDir>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QtConcurrent/QtConcurrentRun>
 
 #undef slots
 #include <boost/python.hpp>
@@ -48,6 +51,7 @@ BOOST_PYTHON_FUNCTION_OVERLOADS( check_target_env_output_list_overloads,
                                  CalamaresPython::check_target_env_output,
                                  1,
                                  3 );
+BOOST_PYTHON_FUNCTION_OVERLOADS( target_env_call_batch_overloads, CalamaresPython::target_env_call_batch, 1, 2 );
 BOOST_PYTHON_MODULE( libcalamares )
 {
     bp::object package = bp::scope();
@@ -149,6 +153,13 @@ BOOST_PYTHON_MODULE( libcalamares )
                                                      "Runs the specified command in the chroot of the target system.\n"
                                                      "Returns the program's standard output, and raises a "
                                                      "subprocess.CalledProcessError if something went wrong." ) );
+    bp::def( "target_env_call_batch",
+             &CalamaresPython::target_env_call_batch,
+             target_env_call_batch_overloads( bp::args( "commands", "timeout" ),
+                                              "Runs each of the commands (each a list of arguments) in the "
+                                              "target system, using one shell for all of them.\n"
+                                              "Returns a list with the exit code of each command; the "
+                                              "special codes are the same as for target_env_call." ) );
     bp::def( "obscure",
              &CalamaresPython::obscure,
              bp::args( "s" ),
@@ -228,9 +239,11 @@ PythonJob::exec()
                                      .arg( prettyName() ) );
     }
 
+    auto* h = helper();
+    CalamaresPython::GILLock lock;
     try
     {
-        bp::dict scriptNamespace = helper()->createCleanNamespace();
+        bp::dict scriptNamespace = h->createCleanNamespace();
 
         bp::object calamaresModule = bp::import( "libcalamares" );
         bp::dict calamaresNamespace = bp::extract< bp::dict >( calamaresModule.attr( "__dict__" ) );
@@ -239,8 +252,14 @@ PythonJob::exec()
         calamaresNamespace[ "globalstorage" ]
             = CalamaresPython::GlobalStoragePythonWrapper( JobQueue::instance()->globalStorage() );
 
-        bp::object execResult
-            = bp::exec_file( scriptFI.absoluteFilePath().toLocal8Bit().data(), scriptNamespace, scriptNamespace );
+        // The code may already have been compiled by prewarm()
+        bp::object code = h->compile( scriptFI.absoluteFilePath() );
+        PyObject* result = PyEval_EvalCode( code.ptr(), scriptNamespace.ptr(), scriptNamespace.ptr() );
+        if ( !result )
+        {
+            bp::throw_error_already_set();
+        }
+        bp::object execResult { bp::handle<>( result ) };
 
         bp::object entryPoint = scriptNamespace[ "run" ];
         bp::object prettyNameFunc = scriptNamespace.get( "pretty_name", bp::object() );
@@ -296,7 +315,7 @@ PythonJob::exec()
         QString msg;
         if ( PyErr_Occurred() )
         {
-            msg = helper()->handleLastError();
+            msg = h->handleLastError();
         }
         bp::handle_exception();
         PyErr_Clear();
@@ -313,9 +332,28 @@ PythonJob::emitProgress( qreal progressValue )
 }
 
 
+void
+PythonJob::prewarm()
+{
+    const QString script = QDir( m_workingPath ).absoluteFilePath( m_scriptFile );
+    // The interpreter is initialized here, in the thread that loads the
+    // modules, and not in whichever pool thread gets to compile first.
+    auto* h = helper();
+    QtConcurrent::run( [h, script]() {
+        CalamaresPython::GILLock lock;
+        h->prewarm( script );
+    } );
+}
+
+
 CalamaresPython::Helper*
 PythonJob::helper()
 {
+    // The helper is normally created by prewarm(), in the main thread;
+    // a job that was not prewarmed creates it in the job thread.
+    static QMutex mutex;
+    QMutexLocker lock( &mutex );
+
     auto ptr = CalamaresPython::Helper::s_instance;
     if ( !ptr )
     {
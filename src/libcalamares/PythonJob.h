@@ -46,12 +46,22 @@ public:
     QString prettyStatusMessage() const override;
     JobResult exec() override;
 
+    /** @brief Prepare the script in the background
+     *
+     * Compiles the script (and imports commonly-used Python modules)
+     * in a background thread, so that exec() has less to do later.
+     * This is optional: exec() compiles the script if needed.
+     * Call this from the main thread, which is where the Python
+     * interpreter is then initialized.
+     */
+    void prewarm();
+
 private:
     friend class CalamaresPython::Helper;
     friend class CalamaresPython::PythonJobInterface;
     void emitProgress( double progressValue );
 
-    CalamaresPython::Helper* helper();
+    static CalamaresPython::Helper* helper();
     QString m_scriptFile;
     QString m_workingPath;
     QString m_description;
@@ -148,6 +148,33 @@ check_target_env_output( const bp::list& args, const std::string& stdin, int tim
     return ec.second.toStdString();
 }
 
+bp::list
+target_env_call_batch( const bp::list& commands, int timeout )
+{
+    QList< QStringList > commandList;
+    for ( int i = 0; i < bp::len( commands ); ++i )
+    {
+        bp::extract< bp::list > args( commands[ i ] );
+        if ( args.check() )
+        {
+            commandList.append( _bp_list_to_qstringlist( args() ) );
+        }
+        else
+        {
+            commandList.append( QStringList { QString::fromStdString( bp::extract< std::string >( commands[ i ] ) ) } );
+        }
+    }
+
+    bp::list exitCodes;
+    const auto results
+        = CalamaresUtils::System::instance()->targetEnvCommands( commandList, std::chrono::seconds( timeout ) );
+    for ( const auto& r : results )
+    {
+        exitCodes.append( r.getExitCode() );
+    }
+    return exitCodes;
+}
+
 void
 debug( const std::string& s )
 {
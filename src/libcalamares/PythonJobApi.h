@@ -49,6 +49,8 @@ check_target_env_output( const std::string& command, const std::string& stdin =
 std::string
 check_target_env_output( const boost::python::list& args, const std::string& stdin = std::string(), int timeout = 0 );
 
+boost::python::list target_env_call_batch( const boost::python::list& commands, int timeout = 0 );
+
 std::string obscure( const std::string& string );
 
 boost::python::object gettext_path();
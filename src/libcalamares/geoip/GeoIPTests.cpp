@@ -23,6 +23,7 @@
 #include "GeoIPXML.h"
 #endif
 #include "Handler.h"
+#include "MultiHandler.h"
 
 #include "network/Manager.h"
 
@@ -194,6 +195,46 @@ GeoIPTests::testSplitTZ()
     QCOMPARE( tz.second, QStringLiteral( "North_Dakota/Beulah" ) );
 }
 
+void
+GeoIPTests::testIpRange()
+{
+    using namespace CalamaresUtils::GeoIP;
+
+    QTemporaryFile f;
+    QVERIFY( f.open() );
+    f.write( "# Test ranges\n"
+             "10.0.0.0/8       America/New_York\n"
+             "10.1.0.0/16      Europe/Amsterdam\n"
+             "\n"
+             "192.168.0.0/16   Moon\n"
+             "2001:db8::/32    Asia/Tokyo\n" );
+    f.close();
+
+    // Most specific range wins, regardless of order
+    auto tz = lookupIpRange( f.fileName(), { QHostAddress( "10.1.2.3" ) } );
+    QCOMPARE( tz.first, QStringLiteral( "Europe" ) );
+    QCOMPARE( tz.second, QStringLiteral( "Amsterdam" ) );
+
+    tz = lookupIpRange( f.fileName(), { QHostAddress( "172.16.0.1" ), QHostAddress( "10.2.2.3" ) } );
+    QCOMPARE( tz.first, QStringLiteral( "America" ) );
+
+    tz = lookupIpRange( f.fileName(), { QHostAddress( "2001:db8::1" ) } );
+    QCOMPARE( tz.second, QStringLiteral( "Tokyo" ) );
+
+    // Bogus zone, no match, no file
+    QVERIFY( !lookupIpRange( f.fileName(), { QHostAddress( "192.168.1.1" ) } ).isValid() );
+    QVERIFY( !lookupIpRange( f.fileName(), { QHostAddress( "172.16.0.1" ) } ).isValid() );
+    QVERIFY( !lookupIpRange( QStringLiteral( "/nonexistent/ranges" ), { QHostAddress( "10.1.2.3" ) } ).isValid() );
+
+    // A handler with only a fallback is still valid
+    MultiHandler h;
+    QVERIFY( !h.isValid() );
+    h.addHandler( QStringLiteral( "bogus" ), QStringLiteral( "http://example.com" ), QString() );
+    QCOMPARE( h.count(), 0 );
+    h.setFallbackDatabase( f.fileName() );
+    QVERIFY( h.isValid() );
+}
+
 
 #define CHECK_GET( t, selector, url ) \
     { \
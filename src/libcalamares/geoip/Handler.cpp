@@ -138,6 +138,17 @@ Handler::get() const
 }
 
 
+RegionZonePair
+Handler::interpret( const QByteArray& data ) const
+{
+    const auto interface = create_interface( m_type, m_selector );
+    if ( !interface )
+    {
+        return RegionZonePair();
+    }
+    return interface->processReply( data );
+}
+
 QFuture< RegionZonePair >
 Handler::query() const
 {
@@ -78,6 +78,14 @@ public:
     /// @brief Like query, but don't interpret the contents
     QFuture< QString > queryRaw() const;
 
+    /** @brief Interpret @p data as if it was returned from the URL
+     *
+     * This is for callers that do their own fetching (e.g. to run
+     * several handlers at once). An invalid Handler will return
+     * an invalid (empty) result.
+     */
+    RegionZonePair interpret( const QByteArray& data ) const;
+
     bool isValid() const { return m_type != Type::None; }
     Type type() const { return m_type; }
     QString url() const { return m_url; }
@@ -0,0 +1,327 @@
+/* === This file is part of Calamares - <http://github.com/calamares> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Calamares is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Calamares is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Calamares. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "MultiHandler.h"
+
+#include "network/Manager.h"
+#include "utils/Logger.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QNetworkInterface>
+#include <QNetworkReply>
+#include <QRegExp>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QTextStream>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <memory>
+
+#include <unistd.h>
+
+namespace CalamaresUtils
+{
+namespace GeoIP
+{
+
+MultiHandler::MultiHandler()
+    : m_timeout( 10000 )
+{
+}
+
+MultiHandler::~MultiHandler() {}
+
+void
+MultiHandler::addHandler( const QString& implementation, const QString& url, const QString& selector )
+{
+    Handler h( implementation, url, selector );
+    if ( h.isValid() )
+    {
+        m_handlers.push_back( h );
+    }
+}
+
+void
+MultiHandler::setCacheFile( const QString& path )
+{
+    m_cacheFile = path;
+}
+
+/** @brief A directory that only this user can write in, or empty
+ *
+ * The runtime directory is private already (Qt checks that); the
+ * calamares directory in it is made private, too.
+ */
+static QString
+privateCacheDirectory()
+{
+    const QString runtime = QStandardPaths::writableLocation( QStandardPaths::RuntimeLocation );
+    if ( runtime.isEmpty() || !QDir( runtime ).mkpath( QStringLiteral( "calamares" ) ) )
+    {
+        return QString();
+    }
+
+    const QString path = QDir( runtime ).filePath( QStringLiteral( "calamares" ) );
+    QFileInfo fi( path );
+    if ( fi.isSymLink() || !fi.isDir() || fi.ownerId() != geteuid()
+         || !QFile::setPermissions( path, QFileDevice::ReadOwner | QFileDevice::WriteOwner | QFileDevice::ExeOwner ) )
+    {
+        cWarning() << "GeoIP cache directory" << path << "is not private.";
+        return QString();
+    }
+    return path;
+}
+
+QString
+MultiHandler::defaultCacheFile() const
+{
+    const QString dir = privateCacheDirectory();
+    if ( dir.isEmpty() )
+    {
+        return QString();
+    }
+
+    QCryptographicHash hash( QCryptographicHash::Sha1 );
+    for ( const auto& h : m_handlers )
+    {
+        hash.addData( h.url().toUtf8() );
+        hash.addData( "\n" );
+        hash.addData( h.selector().toUtf8() );
+        hash.addData( "\n" );
+    }
+    return QDir( dir ).filePath(
+        QStringLiteral( "geoip-%1.txt" ).arg( QString::fromLatin1( hash.result().toHex().left( 12 ) ) ) );
+}
+
+void
+MultiHandler::setFallbackDatabase( const QString& path )
+{
+    m_fallbackDatabase = path;
+}
+
+static RegionZonePair
+readCache( const QString& path )
+{
+    if ( path.isEmpty() )
+    {
+        return RegionZonePair();
+    }
+
+    // Only trust a file that nobody else can have written
+    QFileInfo fi( path );
+    if ( !fi.exists() || fi.isSymLink() || !fi.isFile() || fi.ownerId() != geteuid()
+         || ( fi.permissions() & ( QFileDevice::WriteGroup | QFileDevice::WriteOther ) ) )
+    {
+        return RegionZonePair();
+    }
+
+    QFile f( path );
+    if ( !f.open( QIODevice::ReadOnly | QIODevice::Text ) )
+    {
+        return RegionZonePair();
+    }
+    return splitTZString( QString::fromUtf8( f.readLine() ).trimmed() );
+}
+
+static void
+writeCache( const QString& path, const RegionZonePair& tz )
+{
+    // QSaveFile replaces the file (or a symlink in its place), and does
+    // not write through it; the new file is private to this user.
+    QSaveFile f( path );
+    if ( path.isEmpty() || !f.open( QIODevice::WriteOnly | QIODevice::Text ) )
+    {
+        return;
+    }
+    f.setPermissions( QFileDevice::ReadOwner | QFileDevice::WriteOwner );
+    f.write( QStringLiteral( "%1/%2\n" ).arg( tz.first, tz.second ).toUtf8() );
+    if ( !f.commit() )
+    {
+        cWarning() << "Could not write GeoIP cache" << path;
+    }
+}
+
+RegionZonePair
+MultiHandler::race() const
+{
+    using namespace CalamaresUtils::Network;
+
+    auto& nam = Manager::instance();
+    const RequestOptions options( RequestOptions::FollowRedirect, m_timeout );
+
+    // The replies are handled in the event loop below; the handlers keep
+    // the state alive themselves, rather than refer to this stack frame.
+    struct RaceState
+    {
+        QEventLoop loop;
+        RegionZonePair result;
+        int pending = 0;
+    };
+    auto state = std::make_shared< RaceState >();
+    QVector< QNetworkReply* > replies;
+    replies.reserve( count() );
+
+    for ( const auto& h : m_handlers )
+    {
+        QNetworkReply* reply = nam.asynchronouseGet( QUrl( h.url() ), options );
+        if ( !reply )
+        {
+            cWarning() << "GeoIP lookup at" << h.url() << "could not be started.";
+            continue;
+        }
+        replies.append( reply );
+        ++state->pending;
+        QObject::connect( reply, &QNetworkReply::finished, &state->loop, [state, h, reply]() {
+            --state->pending;
+            if ( !state->result.isValid() && reply->error() == QNetworkReply::NoError )
+            {
+                state->result = h.interpret( reply->readAll() );
+                if ( state->result.isValid() )
+                {
+                    cDebug() << "GeoIP result from" << h.url() << state->result.first << state->result.second;
+                }
+            }
+            if ( state->result.isValid() || state->pending <= 0 )
+            {
+                state->loop.quit();
+            }
+        } );
+    }
+
+    if ( state->pending > 0 )
+    {
+        state->loop.exec();
+    }
+
+    // The losers of the race are not interesting any more
+    for ( auto* reply : replies )
+    {
+        reply->disconnect( &state->loop );
+        if ( reply->isRunning() )
+        {
+            reply->abort();
+        }
+        delete reply;
+    }
+    return state->result;
+}
+
+RegionZonePair
+MultiHandler::get() const
+{
+    RegionZonePair tz = readCache( m_cacheFile );
+    if ( tz.isValid() )
+    {
+        cDebug() << "GeoIP result from cache" << m_cacheFile;
+        return tz;
+    }
+
+    if ( !m_handlers.empty() )
+    {
+        tz = race();
+        if ( tz.isValid() )
+        {
+            writeCache( m_cacheFile, tz );
+            return tz;
+        }
+        cWarning() << "GeoIP lookup failed for all" << count() << "providers.";
+    }
+
+    if ( !m_fallbackDatabase.isEmpty() )
+    {
+        QList< QHostAddress > addresses;
+        for ( const auto& a : QNetworkInterface::allAddresses() )
+        {
+            if ( !a.isLoopback() )
+            {
+                addresses.append( a );
+            }
+        }
+        // Not cached: it is cheap, and a later online lookup is better.
+        tz = lookupIpRange( m_fallbackDatabase, addresses );
+        if ( tz.isValid() )
+        {
+            cDebug() << "GeoIP result from fallback database" << m_fallbackDatabase;
+        }
+    }
+    return tz;
+}
+
+QFuture< RegionZonePair >
+MultiHandler::query() const
+{
+    const MultiHandler self( *this );
+    return QtConcurrent::run( [=] { return self.get(); } );
+}
+
+RegionZonePair
+lookupIpRange( const QString& filename, const QList< QHostAddress >& addresses )
+{
+    QFile f( filename );
+    if ( !f.open( QIODevice::ReadOnly | QIODevice::Text ) )
+    {
+        cWarning() << "GeoIP fallback database" << filename << "can not be read.";
+        return RegionZonePair();
+    }
+
+    RegionZonePair best;
+    int bestPrefix = -1;
+
+    QTextStream in( &f );
+    while ( !in.atEnd() )
+    {
+        const QString line = in.readLine().trimmed();
+        if ( line.isEmpty() || line.startsWith( '#' ) )
+        {
+            continue;
+        }
+
+        const QStringList parts = line.split( QRegExp( "\\s+" ), QString::SkipEmptyParts );
+        if ( parts.count() != 2 )
+        {
+            continue;
+        }
+        const auto subnet = QHostAddress::parseSubnet( parts.at( 0 ) );
+        if ( subnet.first.isNull() || subnet.second <= bestPrefix )
+        {
+            continue;
+        }
+        for ( const auto& a : addresses )
+        {
+            if ( a.isInSubnet( subnet ) )
+            {
+                RegionZonePair tz = splitTZString( parts.at( 1 ) );
+                if ( tz.isValid() )
+                {
+                    best = tz;
+                    bestPrefix = subnet.second;
+                }
+                break;
+            }
+        }
+    }
+    return best;
+}
+
+}  // namespace GeoIP
+}  // namespace CalamaresUtils
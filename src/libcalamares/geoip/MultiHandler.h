@@ -0,0 +1,140 @@
+/* === This file is part of Calamares - <http://github.com/calamares> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Calamares is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Calamares is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Calamares. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef GEOIP_MULTIHANDLER_H
+#define GEOIP_MULTIHANDLER_H
+
+#include "Handler.h"
+
+#include <QFuture>
+#include <QHostAddress>
+#include <QList>
+#include <QString>
+
+#include <chrono>
+#include <vector>
+
+namespace CalamaresUtils
+{
+namespace GeoIP
+{
+
+/** @brief GeoIP lookup from several providers at once
+ *
+ * A MultiHandler holds a list of providers (each one a Handler),
+ * which are all queried at the same time; the first provider to
+ * return a valid result wins and the others are abandoned.
+ *
+ * Optionally, the result is cached in a file, so that later lookups
+ * in the same session (e.g. after a restart of Calamares) are
+ * immediate. If none of the providers returns a result, a local
+ * database of IP-address ranges is consulted, if one is configured.
+ */
+class DLLEXPORT MultiHandler
+{
+public:
+    /** @brief An empty handler; this always returns errors. */
+    MultiHandler();
+    ~MultiHandler();
+
+    /** @brief Add a provider
+     *
+     * See Handler for the meaning of the parameters. Providers
+     * that are not valid (e.g. with an unknown @p implementation)
+     * are not added.
+     */
+    void addHandler( const QString& implementation, const QString& url, const QString& selector );
+
+    /** @brief Cache results in the file @p path
+     *
+     * An empty @p path switches off caching. The cache file
+     * is read before asking any provider (if it is a regular file
+     * that belongs to this user, and nobody else can write to it),
+     * and is replaced after a successful lookup.
+     */
+    void setCacheFile( const QString& path );
+    /** @brief A cache-file name in a private runtime directory
+     *
+     * The directory is "calamares" in the user's runtime directory,
+     * and only the user can use it. The name depends on the configured
+     * providers, so that differently-configured lookups do not share
+     * a cache. Returns an empty name (no caching) if there is no
+     * such directory.
+     */
+    QString defaultCacheFile() const;
+
+    /** @brief Use the IP-range database in @p path as a fallback
+     *
+     * See lookupIpRange() for the file format. An empty @p path
+     * switches off the fallback.
+     */
+    void setFallbackDatabase( const QString& path );
+
+    /// @brief Set the timeout for each provider (default 10 seconds)
+    void setTimeout( std::chrono::milliseconds timeout ) { m_timeout = timeout; }
+
+    /** @brief Synchronously get the GeoIP result.
+     *
+     * Tries the cache, then all the providers at once, then the
+     * fallback database. Returns an invalid zone pair if none
+     * of them give an answer.
+     */
+    RegionZonePair get() const;
+    /** @brief Asynchronously get the GeoIP result.
+     *
+     * See get() for the return value.
+     */
+    QFuture< RegionZonePair > query() const;
+
+    /// @brief Are there any providers or a fallback?
+    bool isValid() const { return !m_handlers.empty() || !m_fallbackDatabase.isEmpty(); }
+    /// @brief How many providers are there?
+    int count() const { return static_cast< int >( m_handlers.size() ); }
+
+private:
+    RegionZonePair race() const;
+
+    std::vector< Handler > m_handlers;
+    QString m_cacheFile;
+    QString m_fallbackDatabase;
+    std::chrono::milliseconds m_timeout;
+};
+
+/** @brief Look up the addresses in an IP-range database
+ *
+ * The database in @p filename is a text file with one range per
+ * line: a subnet in CIDR notation and a timezone in <region>/<zone>
+ * format, separated by whitespace. Empty lines and lines starting
+ * with `#` are ignored. For example:
+ *
+ * ```
+ *    # Main campus
+ *    10.1.0.0/16     Europe/Amsterdam
+ *    2001:db8::/32   America/New_York
+ * ```
+ *
+ * Each of the @p addresses is looked up, and the zone of the most
+ * specific (longest-prefix) range that contains any of them is returned.
+ * Returns an invalid zone pair if there is no match.
+ */
+DLLEXPORT RegionZonePair lookupIpRange( const QString& filename, const QList< QHostAddress >& addresses );
+
+}  // namespace GeoIP
+}  // namespace CalamaresUtils
+#endif
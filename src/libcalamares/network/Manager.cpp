@@ -18,8 +18,12 @@
 
 #include "Manager.h"
 
+#include "GlobalStorage.h"
+#include "JobQueue.h"
 #include "utils/Logger.h"
 
+#include <QCoreApplication>
+#include <QElapsedTimer>
 #include <QEventLoop>
 #include <QMutex>
 #include <QMutexLocker>
@@ -48,6 +52,11 @@ RequestOptions::applyToRequest( QNetworkRequest* request ) const
         // sourceforge.net), so let's set a more descriptive one.
         request->setRawHeader( "User-Agent", "Mozilla/5.0 (compatible; Calamares)" );
     }
+
+    for ( const auto& header : m_headers )
+    {
+        request->setRawHeader( header.first, header.second );
+    }
 }
 
 class Manager::Private : public QObject
@@ -63,17 +72,45 @@ public slots:
     void cleanupNam();
 
 public:
-    QUrl m_hasInternetUrl;
+    QVector< QUrl > m_hasInternetUrls;
     bool m_hasInternet;
 
+    std::chrono::seconds m_hasInternetTTL;
+    std::chrono::milliseconds m_probeTimeout;
+
+    /// @brief Pending probe replies; only used from the Manager's thread
+    QVector< QNetworkReply* > m_probes;
+
+    /** @brief Guards the check state
+     *
+     * That is m_hasInternetUrls, m_hasInternet, m_hasInternetTTL,
+     * m_probeTimeout, m_lastCheck and m_checkPending; checkHasInternet()
+     * is called from other threads than the one running the probes.
+     */
+    mutable QMutex m_stateMutex;
+    QElapsedTimer m_lastCheck;  ///< Invalid until the first check completes
+    bool m_checkPending;
+
     Private();
 
     QNetworkAccessManager* nam();
+
+    /// @brief Is the last check result still within its time-to-live?
+    bool isFresh() const;
+    /// @brief The last check result
+    bool hasInternet() const
+    {
+        QMutexLocker lock( &m_stateMutex );
+        return m_hasInternet;
+    }
 };
 
 Manager::Private::Private()
     : m_nam( std::make_unique< QNetworkAccessManager >() )
     , m_hasInternet( false )
+    , m_hasInternetTTL( 30 )
+    , m_probeTimeout( 5000 )
+    , m_checkPending( false )
 {
     m_perThreadNams.reserve( 20 );
     m_perThreadNams.append( qMakePair( QThread::currentThread(), m_nam.get() ) );
@@ -134,10 +171,27 @@ Manager::Private::cleanupNam()
     }
 }
 
+bool
+Manager::Private::isFresh() const
+{
+    QMutexLocker lock( &m_stateMutex );
+    if ( !m_lastCheck.isValid() || m_hasInternetTTL.count() <= 0 )
+    {
+        return false;
+    }
+    return m_lastCheck.elapsed() < std::chrono::duration_cast< std::chrono::milliseconds >( m_hasInternetTTL ).count();
+}
+
 
 Manager::Manager()
     : d( std::make_unique< Private >() )
 {
+    // The connectivity probes need an event loop; if the instance
+    // is created from a worker thread, move it to the main thread.
+    if ( QCoreApplication::instance() )
+    {
+        moveToThread( QCoreApplication::instance()->thread() );
+    }
 }
 
 Manager::~Manager() {}
@@ -152,26 +206,182 @@ Manager::instance()
 bool
 Manager::hasInternet()
 {
-    return d->m_hasInternet;
+    return d->hasInternet();
 }
 
 bool
 Manager::checkHasInternet()
 {
-    bool hasInternet = d->nam()->networkAccessible() == QNetworkAccessManager::Accessible;
+    if ( d->isFresh() )
+    {
+        return d->hasInternet();
+    }
+
+    const auto accessible = d->nam()->networkAccessible();
+    if ( accessible != QNetworkAccessManager::UnknownAccessibility )
+    {
+        // The network-access manager knows; no need to ping anything.
+        bool hasInternet = accessible == QNetworkAccessManager::Accessible;
+        QMetaObject::invokeMethod( this, "setHasInternet", Q_ARG( bool, hasInternet ) );
+        return hasInternet;
+    }
+
+    // Don't wait for the probes; whoever is interested hears
+    // about their result through checkHasInternetDone().
+    checkHasInternetAsync();
+    return d->hasInternet();
+}
+
+void
+Manager::checkHasInternetAsync()
+{
+    if ( QThread::currentThread() != thread() )
+    {
+        {
+            QMutexLocker lock( &d->m_stateMutex );
+            if ( d->m_checkPending )
+            {
+                return;
+            }
+            d->m_checkPending = true;
+        }
+        QMetaObject::invokeMethod( this, "checkHasInternetAsync", Qt::QueuedConnection );
+        return;
+    }
+
+    if ( !d->m_probes.isEmpty() )
+    {
+        return;
+    }
+    if ( d->isFresh() )
+    {
+        // Someone may be waiting for this (queued) check, so report.
+        {
+            QMutexLocker lock( &d->m_stateMutex );
+            d->m_checkPending = false;
+        }
+        emit checkHasInternetDone( d->hasInternet() );
+        return;
+    }
+    QVector< QUrl > urls;
+    std::chrono::milliseconds timeout;
+    {
+        QMutexLocker lock( &d->m_stateMutex );
+        d->m_checkPending = true;
+        urls = d->m_hasInternetUrls;
+        timeout = d->m_probeTimeout;
+    }
+
+    const RequestOptions options( RequestOptions::FakeUserAgent | RequestOptions::FollowRedirect, timeout );
+    for ( const auto& url : urls )
+    {
+        QNetworkReply* reply = asynchronouseGet( url, options );
+        if ( reply )
+        {
+            d->m_probes.append( reply );
+            connect( reply, &QNetworkReply::finished, this, [this, reply]() { probeFinished( reply ); } );
+        }
+    }
 
-    if ( !hasInternet && ( d->nam()->networkAccessible() == QNetworkAccessManager::UnknownAccessibility ) )
+    if ( d->m_probes.isEmpty() )
     {
-        hasInternet = synchronousPing( d->m_hasInternetUrl );
+        cWarning() << "No usable URL to check for internet connectivity.";
+        setHasInternet( false );
     }
-    d->m_hasInternet = hasInternet;
-    return hasInternet;
+}
+
+void
+Manager::probeFinished( QNetworkReply* reply )
+{
+    d->m_probes.removeAll( reply );
+    reply->deleteLater();
+
+    const bool ok = ( reply->error() == QNetworkReply::NoError ) && reply->bytesAvailable();
+    if ( ok )
+    {
+        cDebug() << "Internet connectivity confirmed by" << reply->url();
+        // One answer is enough, the remaining probes are no longer interesting.
+        for ( auto* r : d->m_probes )
+        {
+            r->disconnect( this );
+            r->abort();
+            r->deleteLater();
+        }
+        d->m_probes.clear();
+    }
+
+    if ( ok || d->m_probes.isEmpty() )
+    {
+        setHasInternet( ok );
+    }
+}
+
+void
+Manager::setHasInternet( bool b )
+{
+    bool changed = false;
+    {
+        QMutexLocker lock( &d->m_stateMutex );
+        changed = b != d->m_hasInternet;
+        d->m_hasInternet = b;
+        d->m_lastCheck.start();
+        d->m_checkPending = false;
+    }
+
+    auto* jobQueue = Calamares::JobQueue::instance();
+    if ( jobQueue && jobQueue->globalStorage() )
+    {
+        jobQueue->globalStorage()->insert( "hasInternet", b );
+    }
+
+    if ( changed )
+    {
+        emit hasInternetChanged( b );
+    }
+    emit checkHasInternetDone( b );
 }
 
 void
 Manager::setCheckHasInternetUrl( const QUrl& url )
 {
-    d->m_hasInternetUrl = url;
+    setCheckHasInternetUrl( QVector< QUrl > { url } );
+}
+
+void
+Manager::setCheckHasInternetUrl( const QVector< QUrl >& urls )
+{
+    QMutexLocker lock( &d->m_stateMutex );
+    d->m_hasInternetUrls.clear();
+    for ( const auto& u : urls )
+    {
+        if ( u.isValid() )
+        {
+            d->m_hasInternetUrls.append( u );
+        }
+    }
+    // Different URLs may give a different answer
+    d->m_lastCheck.invalidate();
+}
+
+QVector< QUrl >
+Manager::getCheckInternetUrls() const
+{
+    QMutexLocker lock( &d->m_stateMutex );
+    return d->m_hasInternetUrls;
+}
+
+void
+Manager::setCheckHasInternetTTL( std::chrono::seconds ttl )
+{
+    QMutexLocker lock( &d->m_stateMutex );
+    d->m_hasInternetTTL = ttl;
+}
+
+void
+Manager::setCheckHasInternetTimeout( std::chrono::milliseconds timeout )
+{
+    QMutexLocker lock( &d->m_stateMutex );
+    d->m_probeTimeout = timeout;
 }
 
 /** @brief Does a request asynchronously, returns the (pending) reply
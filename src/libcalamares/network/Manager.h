@@ -22,8 +22,11 @@
 #include "DllMacro.h"
 
 #include <QByteArray>
+#include <QList>
 #include <QObject>
+#include <QPair>
 #include <QUrl>
+#include <QVector>
 
 #include <chrono>
 #include <memory>
@@ -64,9 +67,22 @@ public:
     bool hasTimeout() const { return m_timeout > milliseconds( 0 ); }
     auto timeout() const { return m_timeout; }
 
+    /** @brief Add a header to send with the request
+     *
+     * This is for headers that are specific to a single request,
+     * e.g. `If-None-Match` for conditional requests. Returns
+     * the options themselves, so calls can be chained.
+     */
+    RequestOptions& addHeader( const QByteArray& name, const QByteArray& value )
+    {
+        m_headers.append( qMakePair( name, value ) );
+        return *this;
+    }
+
 private:
     Flags m_flags;
     milliseconds m_timeout;
+    QList< QPair< QByteArray, QByteArray > > m_headers;
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS( RequestOptions::Flags );
@@ -90,9 +106,10 @@ struct RequestStatus
     State status;
 };
 
-class DLLEXPORT Manager : QObject
+class DLLEXPORT Manager : public QObject
 {
     Q_OBJECT
+    Q_PROPERTY( bool hasInternet READ hasInternet NOTIFY hasInternetChanged FINAL )
 
     Manager();
 
@@ -125,10 +142,36 @@ public:
 
     /// @brief Set the URL which is used for the general "is there internet" check.
     void setCheckHasInternetUrl( const QUrl& url );
+    /** @brief Set the URLs which are used for the "is there internet" check.
+     *
+     * All of the URLs are probed in parallel; if any one of them returns
+     * data, there is internet connectivity. Invalid URLs are dropped.
+     */
+    void setCheckHasInternetUrl( const QVector< QUrl >& urls );
+    /// @brief The URLs which are used for the "is there internet" check.
+    QVector< QUrl > getCheckInternetUrls() const;
+
+    /** @brief Set how long the result of a connectivity check is valid
+     *
+     * Within this time, checkHasInternet() returns the cached result
+     * of the previous check instead of probing again. A zero (or negative)
+     * time-to-live disables caching.
+     */
+    void setCheckHasInternetTTL( std::chrono::seconds ttl );
+    /** @brief Set the timeout for each connectivity probe
+     *
+     * Since probes run in parallel, this is also (roughly) the
+     * longest time before a check reports its result.
+     */
+    void setCheckHasInternetTimeout( std::chrono::milliseconds timeout );
+
     /** @brief Do an explicit check for internet connectivity.
      *
-     * This **may** do a ping to the configured check URL, but can also
-     * use other mechanisms.
+     * This never waits for the network. If a recent result is cached,
+     * or the network-access manager knows the answer, that is returned.
+     * Otherwise this starts a check (see checkHasInternetAsync()) and
+     * returns the previous result; the new result is reported through
+     * checkHasInternetDone() when it arrives.
      */
     bool checkHasInternet();
     /** @brief Is there internet connectivity?
@@ -148,7 +191,31 @@ public:
      */
     QNetworkReply* asynchronouseGet( const QUrl& url, const RequestOptions& options = RequestOptions() );
 
+public Q_SLOTS:
+    /** @brief Start a check for internet connectivity and return immediately
+     *
+     * The result is reported through hasInternetChanged() (if it changed)
+     * and checkHasInternetDone(), and is stored in GlobalStorage as
+     * *hasInternet*. If a cached result is still fresh, or a check
+     * is already running, this does nothing.
+     *
+     * This may be called from any thread; the probes are always run
+     * in the thread that the Manager lives in.
+     */
+    void checkHasInternetAsync();
+
+signals:
+    /// @brief Emitted when the connectivity state changes
+    void hasInternetChanged( bool );
+    /// @brief Emitted after each completed connectivity check
+    void checkHasInternetDone( bool );
+
+private Q_SLOTS:
+    void setHasInternet( bool b );
+
 private:
+    void probeFinished( QNetworkReply* reply );
+
     class Private;
     std::unique_ptr< Private > d;
 };
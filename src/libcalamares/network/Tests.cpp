@@ -46,3 +46,27 @@ NetworkTests::testPing()
     auto& nam = CalamaresUtils::Network::Manager::instance();
     QVERIFY( nam.synchronousPing( QUrl( "https://www.kde.org" ) ) );
 }
+
+void
+NetworkTests::testCheckUrls()
+{
+    using namespace CalamaresUtils::Network;
+    auto& nam = Manager::instance();
+
+    nam.setCheckHasInternetUrl( QUrl( "https://www.kde.org" ) );
+    QCOMPARE( nam.getCheckInternetUrls().count(), 1 );
+
+    // Invalid URLs are dropped
+    nam.setCheckHasInternetUrl(
+        QVector< QUrl > { QUrl( "https://www.kde.org" ), QUrl( "http://[::1" ), QUrl( "https://example.com" ) } );
+    QCOMPARE( nam.getCheckInternetUrls().count(), 2 );
+
+    // No URLs at all means no internet; the async check
+    // finishes immediately in that case.
+    nam.setCheckHasInternetUrl( QVector< QUrl >() );
+    QVERIFY( nam.getCheckInternetUrls().isEmpty() );
+    QSignalSpy spy( &nam, &Manager::checkHasInternetDone );
+    nam.checkHasInternetAsync();
+    QCOMPARE( spy.count(), 1 );
+    QVERIFY( !nam.hasInternet() );
+}
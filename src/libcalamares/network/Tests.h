@@ -33,6 +33,7 @@ private Q_SLOTS:
 
     void testInstance();
     void testPing();
+    void testCheckUrls();
 };
 
 #endif
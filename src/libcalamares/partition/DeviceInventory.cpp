@@ -0,0 +1,212 @@
+/* === This file is part of Calamares - <https://github.com/calamares> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Calamares is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Calamares is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Calamares. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "DeviceInventory.h"
+
+#include "utils/Logger.h"
+
+#include <QDir>
+#include <QFile>
+#include <QMutexLocker>
+#include <QProcess>
+#include <QtConcurrent/QtConcurrent>
+
+namespace CalamaresUtils
+{
+namespace Partition
+{
+
+static const char sysBlock[] = "/sys/block";
+
+/// @brief Reads a (small) sysfs attribute, returns empty on failure
+static QByteArray
+readAttribute( const QString& path )
+{
+    QFile f( path );
+    if ( f.open( QIODevice::ReadOnly ) )
+    {
+        return f.readAll().trimmed();
+    }
+    return QByteArray();
+}
+
+/** @brief Kernel names of devices that are never installation targets
+ *
+ * These are optical and floppy drives, loop devices (e.g. the squashfs
+ * of the live system) and RAM-backed devices (ram, zram, ramzswap).
+ */
+static bool
+isVirtualOrOptical( const QString& name )
+{
+    for ( const char* prefix : { "sr", "fd", "loop", "ram", "zram" } )
+    {
+        if ( name.startsWith( QLatin1String( prefix ) ) )
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/** @brief Runs blkid once, for all devices, and collects TYPE= per node
+ *
+ * Lines look like `/dev/sda1: UUID="..." TYPE="ext4" PARTUUID="..."`;
+ * the leading space keeps PTTYPE= and SEC_TYPE= from matching.
+ */
+static QHash< QString, QString >
+blkidFilesystems()
+{
+    QHash< QString, QString > filesystems;
+
+    QProcess blkid;
+    blkid.start( "blkid", QStringList() );
+    if ( !blkid.waitForFinished( 10000 ) )
+    {
+        cWarning() << "Could not run blkid for the device inventory.";
+        blkid.kill();
+        blkid.waitForFinished();
+        return filesystems;
+    }
+
+    static const QString typeKey = QStringLiteral( " TYPE=\"" );
+    const QStringList lines = QString::fromLocal8Bit( blkid.readAllStandardOutput() ).split( '\n' );
+    for ( const QString& line : lines )
+    {
+        const int colon = line.indexOf( ':' );
+        const int type = line.indexOf( typeKey, colon );
+        if ( colon < 1 || type < 0 )
+        {
+            continue;
+        }
+        const int valueStart = type + typeKey.length();
+        const int valueEnd = line.indexOf( '"', valueStart );
+        if ( valueEnd > valueStart )
+        {
+            filesystems.insert( line.left( colon ), line.mid( valueStart, valueEnd - valueStart ) );
+        }
+    }
+    return filesystems;
+}
+
+DeviceInventory::DeviceInventory()
+    : m_started( false )
+{
+}
+
+DeviceInventory&
+DeviceInventory::instance()
+{
+    static auto* s_inventory = new DeviceInventory();
+    return *s_inventory;
+}
+
+bool
+DeviceInventory::isSupported()
+{
+    return QDir( sysBlock ).exists();
+}
+
+DeviceInventory::Snapshot
+DeviceInventory::scan()
+{
+    Snapshot snapshot;
+
+    QDir block( sysBlock );
+    const QStringList names = block.entryList( QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name );
+    for ( const QString& name : names )
+    {
+        const QString sysPath = block.filePath( name );
+
+        BlockDevice device;
+        device.name = name;
+        // Kernel names use ! where the device node has a subdirectory, e.g. cciss!c0d0
+        device.node = QStringLiteral( "/dev/" ) + QString( name ).replace( '!', '/' );
+        // The size attribute is always in 512-byte sectors, whatever the hardware
+        device.size = readAttribute( sysPath + QStringLiteral( "/size" ) ).toLongLong() * 512;
+        device.readOnly = readAttribute( sysPath + QStringLiteral( "/ro" ) ) == "1";
+        device.removable = readAttribute( sysPath + QStringLiteral( "/removable" ) ) == "1";
+        device.virtualOrOptical = isVirtualOrOptical( name );
+
+        QDir partitions( sysPath );
+        for ( const QString& part : partitions.entryList( QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name ) )
+        {
+            if ( QFile::exists( partitions.filePath( part ) + QStringLiteral( "/partition" ) ) )
+            {
+                device.partitions.append( QStringLiteral( "/dev/" ) + QString( part ).replace( '!', '/' ) );
+            }
+        }
+
+        snapshot.devices.append( device );
+    }
+
+    snapshot.filesystems = blkidFilesystems();
+    cDebug() << "Device inventory found" << snapshot.devices.count() << "block devices,"
+             << snapshot.filesystems.count() << "with a filesystem type.";
+    return snapshot;
+}
+
+void
+DeviceInventory::refresh()
+{
+    if ( !isSupported() )
+    {
+        return;
+    }
+
+    QMutexLocker lock( &m_mutex );
+    // A scan that is still running is recent enough
+    if ( m_started && m_scan.isRunning() )
+    {
+        return;
+    }
+    m_scan = QtConcurrent::run( &DeviceInventory::scan );
+    m_started = true;
+}
+
+DeviceInventory::Snapshot
+DeviceInventory::snapshot()
+{
+    QFuture< Snapshot > scan;
+    {
+        QMutexLocker lock( &m_mutex );
+        if ( !m_started )
+        {
+            m_scan = QtConcurrent::run( &DeviceInventory::scan );
+            m_started = true;
+        }
+        scan = m_scan;
+    }
+    // Waits (without holding the lock) if the scan is still running
+    return scan.result();
+}
+
+QList< BlockDevice >
+DeviceInventory::devices()
+{
+    return snapshot().devices;
+}
+
+QString
+DeviceInventory::filesystemType( const QString& node )
+{
+    return snapshot().filesystems.value( node );
+}
+
+}  // namespace Partition
+}  // namespace CalamaresUtils
@@ -0,0 +1,120 @@
+/* === This file is part of Calamares - <https://github.com/calamares> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Calamares is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Calamares is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Calamares. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PARTITION_DEVICEINVENTORY_H
+#define PARTITION_DEVICEINVENTORY_H
+
+#include "DllMacro.h"
+
+#include <QFuture>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+
+namespace CalamaresUtils
+{
+namespace Partition
+{
+
+/** @brief A block device as the kernel reports it
+ *
+ * This is the information from /sys/block, which is enough to decide
+ * whether a disk could be installed to; it is not a replacement for
+ * the detailed view of the disk that KPMcore (in the partition module)
+ * builds.
+ */
+struct BlockDevice
+{
+    QString name;  ///< Kernel name, e.g. "sda"
+    QString node;  ///< Device node, e.g. "/dev/sda"
+    qint64 size = 0;  ///< Size in bytes
+    bool readOnly = false;
+    bool removable = false;
+    /// CD / DVD drives, floppies and RAM-backed (zram) devices
+    bool virtualOrOptical = false;
+    /// Device nodes of the partitions on this device
+    QStringList partitions;
+};
+
+/** @brief Shared inventory of the block devices in the system
+ *
+ * Both the requirements checker (is there a big-enough disk?) and the
+ * partition module (which disks may be offered?) need to look at all
+ * the disks; scanning them is slow, so it is done once, in the background,
+ * starting at application launch. Consumers that need the results
+ * wait for the scan to complete if it is still running.
+ *
+ * Call refresh() to re-scan, e.g. after the user asks the partition
+ * module to revert (because a USB stick may have been plugged in).
+ *
+ * All the methods may be called from any thread.
+ */
+class DLLEXPORT DeviceInventory
+{
+public:
+    /** @brief Gets the single inventory.
+     *
+     * The first call does not start a scan; call refresh() for that.
+     */
+    static DeviceInventory& instance();
+
+    /// @brief Is this system supported at all? (Needs /sys/block)
+    static bool isSupported();
+
+    /** @brief Starts a (re-)scan of the devices in the background
+     *
+     * If a scan is already running, or the system is not supported,
+     * this does nothing.
+     */
+    void refresh();
+
+    /// @brief The block devices; waits for a running scan, or starts one
+    QList< BlockDevice > devices();
+
+    /** @brief The filesystem type of a device or partition
+     *
+     * Returns the TYPE that blkid reports for the node, e.g. "iso9660"
+     * or "ext4", or an empty string if unknown. Waits for a running
+     * scan, or starts one if there is none.
+     */
+    QString filesystemType( const QString& node );
+
+private:
+    DeviceInventory();
+
+    struct Snapshot
+    {
+        QList< BlockDevice > devices;
+        QHash< QString, QString > filesystems;  ///< Device node -> TYPE
+    };
+
+    static Snapshot scan();
+    Snapshot snapshot();
+
+    QMutex m_mutex;
+    QFuture< Snapshot > m_scan;
+    bool m_started;
+};
+
+}  // namespace Partition
+}  // namespace CalamaresUtils
+
+#endif
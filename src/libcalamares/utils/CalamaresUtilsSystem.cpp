@@ -23,11 +23,14 @@
 #include "JobQueue.h"
 #include "Settings.h"
 #include "utils/Logger.h"
+#include "utils/TargetSession.h"
 
 #include <QCoreApplication>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QProcess>
 #include <QRegularExpression>
+#include <QThreadStorage>
 
 #ifdef Q_OS_LINUX
 #include <sys/sysinfo.h>
@@ -85,8 +88,158 @@ operator<<( QDebug& s, const RedactedList& l )
 namespace CalamaresUtils
 {
 
+OutputLines::OutputLines( const Handler& handler, int keepLines )
+    : m_handler( handler )
+    , m_keepLines( keepLines )
+{
+}
+
+void
+OutputLines::append( const QByteArray& data )
+{
+    int start = 0;
+    for ( int i = 0; i < data.length(); ++i )
+    {
+        const char c = data.at( i );
+        if ( c == '\n' || c == '\r' )
+        {
+            m_partial.append( data.constData() + start, i - start );
+            addLine( m_partial );
+            m_partial.clear();
+            start = i + 1;
+        }
+    }
+    m_partial.append( data.constData() + start, data.length() - start );
+
+    // Output that never ends a line is passed on in pieces
+    if ( m_partial.length() > 4096 )
+    {
+        addLine( m_partial );
+        m_partial.clear();
+    }
+}
+
+void
+OutputLines::finish()
+{
+    addLine( m_partial );
+    m_partial.clear();
+}
+
+QString
+OutputLines::output() const
+{
+    return m_lines.join( '\n' ).trimmed();
+}
+
+void
+OutputLines::addLine( const QByteArray& line )
+{
+    if ( line.isEmpty() )
+    {
+        return;
+    }
+
+    const QString s = QString::fromLocal8Bit( line );
+    if ( m_handler )
+    {
+        m_handler( s );
+    }
+    m_lines.append( s );
+    if ( m_lines.count() > m_keepLines )
+    {
+        m_lines.removeFirst();
+    }
+}
+
+/// @brief Is all output of commands logged, or only failures?
+static bool
+logAllOutput()
+{
+    return ( !Calamares::Settings::instance() ) || ( Calamares::Settings::instance()->debugMode() );
+}
+
+/** @brief Wraps @p output so that lines are logged, too (when logging all output) */
+static OutputLines::Handler
+loggingHandler( const OutputLines::Handler& output )
+{
+    if ( !logAllOutput() )
+    {
+        return output;
+    }
+    return [output]( const QString& line ) {
+        cDebug() << Logger::SubEntry << line;
+        output( line );
+    };
+}
+
+/** @brief Reads output from @p process into @p lines until it finishes
+ *
+ * Returns @c false if the process is not finished after @p timeout
+ * (if non-zero); it is then killed.
+ */
+static bool
+streamOutput( QProcess& process, std::chrono::seconds timeout, OutputLines& lines )
+{
+    const qint64 limit = timeout > std::chrono::seconds::zero() ? std::chrono::milliseconds( timeout ).count() : -1;
+    QElapsedTimer timer;
+    timer.start();
+
+    while ( process.state() != QProcess::NotRunning )
+    {
+        if ( limit >= 0 && timer.elapsed() >= limit )
+        {
+            process.kill();
+            process.waitForFinished();
+            lines.append( process.readAllStandardOutput() );
+            return false;
+        }
+        process.waitForReadyRead( limit >= 0 ? int( qMax( qint64( 1 ), limit - timer.elapsed() ) ) : -1 );
+        lines.append( process.readAllStandardOutput() );
+    }
+    lines.append( process.readAllStandardOutput() );
+    return true;
+}
+
 System* System::s_instance = nullptr;
 
+/// @brief Sessions are per-thread, since they use a QProcess
+static QThreadStorage< TargetSession* > s_targetSession;
+
+/** @brief The (running) target session for this thread, for @p root
+ *
+ * Returns nullptr if there is no shell in the target.
+ */
+static TargetSession*
+targetSession( const QString& root )
+{
+    TargetSession* session = s_targetSession.localData();
+    if ( !session || session->root() != root )
+    {
+        session = new TargetSession( root );
+        s_targetSession.setLocalData( session );  // Deletes the old one
+    }
+    return session->isRunning() ? session : nullptr;
+}
+
+/** @brief Logs the result of a command, and returns @p r
+ *
+ * If the output was @p streamed, it has been logged line-by-line
+ * already (when logging all output).
+ */
+static ProcessResult
+logResult( const QStringList& args, const ProcessResult& r, bool streamed = false )
+{
+    cDebug() << "Finished. Exit code:" << r.getExitCode();
+    bool showDebug = logAllOutput();
+    if ( !( streamed && showDebug ) && ( ( r.getExitCode() != 0 ) || showDebug ) )
+    {
+        cDebug() << "Target cmd:" << RedactedList( args );
+        cDebug().noquote().nospace() << "Target output:\n" << r.getOutput();
+    }
+    return r;
+}
+
 
 System::System( bool doChroot, QObject* parent )
     : QObject( parent )
@@ -169,7 +322,8 @@ System::runCommand( System::RunLocation location,
                     const QStringList& args,
                     const QString& workingPath,
                     const QString& stdInput,
-                    std::chrono::seconds timeoutSec )
+                    std::chrono::seconds timeoutSec,
+                    const OutputLines::Handler& outputHandler )
 {
     QString output;
 
@@ -195,6 +349,22 @@ System::runCommand( System::RunLocation location,
             return ProcessResult::Code::NoWorkingDirectory;
         }
 
+        // The session can't do standard input or working directories
+        if ( stdInput.isEmpty() && workingPath.isEmpty() )
+        {
+            TargetSession* session = targetSession( destDir );
+            if ( session )
+            {
+                cDebug() << "Running in target" << RedactedList( args );
+                if ( outputHandler )
+                {
+                    OutputLines lines( loggingHandler( outputHandler ) );
+                    return logResult( args, session->run( args, timeoutSec, &lines ), true );
+                }
+                return logResult( args, session->run( args, timeoutSec ) );
+            }
+        }
+
         program = "chroot";
         arguments = QStringList( { destDir } );
         arguments << args;
@@ -236,6 +406,24 @@ System::runCommand( System::RunLocation location,
     }
     process.closeWriteChannel();
 
+    if ( outputHandler )
+    {
+        OutputLines lines( loggingHandler( outputHandler ) );
+        const bool finished = streamOutput( process, timeoutSec, lines );
+        lines.finish();
+        if ( !finished )
+        {
+            cWarning().noquote().nospace() << "Timed out. Output so far:\n" << lines.output();
+            return ProcessResult::Code::TimedOut;
+        }
+        if ( process.exitStatus() == QProcess::CrashExit )
+        {
+            cWarning().noquote().nospace() << "Process crashed. Output so far:\n" << lines.output();
+            return ProcessResult::Code::Crashed;
+        }
+        return logResult( args, ProcessResult( process.exitCode(), lines.output() ), true );
+    }
+
     if ( !process.waitForFinished( timeoutSec > std::chrono::seconds::zero()
                                        ? ( static_cast< int >( std::chrono::milliseconds( timeoutSec ).count() ) )
                                        : -1 ) )
@@ -252,15 +440,49 @@ System::runCommand( System::RunLocation location,
         return ProcessResult::Code::Crashed;
     }
 
-    auto r = process.exitCode();
-    cDebug() << "Finished. Exit code:" << r;
-    bool showDebug = ( !Calamares::Settings::instance() ) || ( Calamares::Settings::instance()->debugMode() );
-    if ( ( r != 0 ) || showDebug )
+    return logResult( args, ProcessResult( process.exitCode(), output ) );
+}
+
+QList< ProcessResult >
+System::runCommands( System::RunLocation location,
+                     const QList< QStringList >& commands,
+                     std::chrono::seconds timeoutSec )
+{
+    Calamares::GlobalStorage* gs
+        = Calamares::JobQueue::instance() ? Calamares::JobQueue::instance()->globalStorage() : nullptr;
+
+    if ( location == System::RunLocation::RunInTarget && gs && gs->contains( "rootMountPoint" )
+         && QDir( gs->value( "rootMountPoint" ).toString() ).exists() )
+    {
+        TargetSession* session = targetSession( gs->value( "rootMountPoint" ).toString() );
+        if ( session )
+        {
+            cDebug() << "Running" << commands.count() << "commands in target";
+            const auto results = session->run( commands, timeoutSec );
+            for ( int i = 0; i < results.count(); ++i )
+            {
+                logResult( commands.at( i ), results.at( i ) );
+            }
+            return results;
+        }
+    }
+
+    // Otherwise one-by-one, which also deals with the error cases
+    QList< ProcessResult > results;
+    for ( const auto& args : commands )
     {
-        cDebug() << "Target cmd:" << RedactedList( args );
-        cDebug().noquote().nospace() << "Target output:\n" << output;
+        results.append( runCommand( location, args, QString(), QString(), timeoutSec ) );
+    }
+    return results;
+}
+
+void
+System::closeTargetSession()
+{
+    if ( s_targetSession.hasLocalData() )
+    {
+        s_targetSession.setLocalData( nullptr );
     }
-    return ProcessResult( r, output );
 }
 
 QString
@@ -393,6 +615,25 @@ System::doChroot() const
     return m_doChroot;
 }
 
+QStringList
+System::targetEnvCommandLine( const QStringList& args ) const
+{
+    if ( !m_doChroot )
+    {
+        return args;
+    }
+
+    Calamares::GlobalStorage* gs
+        = Calamares::JobQueue::instance() ? Calamares::JobQueue::instance()->globalStorage() : nullptr;
+    const QString destDir = gs ? gs->value( "rootMountPoint" ).toString() : QString();
+    if ( destDir.isEmpty() || !QDir( destDir ).exists() )
+    {
+        cWarning() << "No usable rootMountPoint in global storage";
+        return QStringList();
+    }
+    return QStringList { "chroot", destDir } + args;
+}
+
 Calamares::JobResult
 ProcessResult::explainProcess( int ec, const QString& command, const QString& output, std::chrono::seconds timeout )
 {
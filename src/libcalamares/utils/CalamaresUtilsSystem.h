@@ -23,11 +23,14 @@
 
 #include "Job.h"
 
+#include <QList>
 #include <QObject>
 #include <QPair>
 #include <QString>
+#include <QStringList>
 
 #include <chrono>
+#include <functional>
 
 namespace CalamaresUtils
 {
@@ -84,6 +87,39 @@ public:
     }
 };
 
+/** @brief Splits the output of a running command into lines
+ *
+ * Output is fed in as it arrives, and each complete line is passed
+ * to the handler straight away. Both newline and carriage return end
+ * a line, since progress meters often use the latter; empty lines
+ * are dropped. Only the last
+ * few lines are kept, so that a long-running and chatty command does
+ * not use unbounded memory; those are used to explain failures.
+ */
+class DLLEXPORT OutputLines
+{
+public:
+    using Handler = std::function< void( const QString& ) >;
+
+    explicit OutputLines( const Handler& handler, int keepLines = 100 );
+
+    /// @brief Adds @p data, passes on each line that is now complete
+    void append( const QByteArray& data );
+    /// @brief Passes on the last line, if it was not terminated
+    void finish();
+
+    /// @brief The last (kept) lines of output, joined
+    QString output() const;
+
+private:
+    void addLine( const QByteArray& line );
+
+    Handler m_handler;
+    QByteArray m_partial;
+    QStringList m_lines;
+    int m_keepLines;
+};
+
 /**
  * @brief The System class is a singleton with utility functions that perform
  * system-specific operations.
@@ -138,6 +174,9 @@ public:
       *        standard input (optional).
       * @param timeoutSec the timeout after which the process will be
       *        killed (optional, default is 0 i.e. no timeout).
+      * @param output called with each line of output while the process
+      *        runs (optional). When this is given, the result holds
+      *        only the last lines of output.
       *
       * @returns the program's exit code and its output (if any). Special
       *     exit codes (which will never have any output) are:
@@ -150,7 +189,29 @@ public:
                                                const QStringList& args,
                                                const QString& workingPath = QString(),
                                                const QString& stdInput = QString(),
-                                               std::chrono::seconds timeoutSec = std::chrono::seconds( 0 ) );
+                                               std::chrono::seconds timeoutSec = std::chrono::seconds( 0 ),
+                                               const OutputLines::Handler& output = OutputLines::Handler() );
+
+    /** @brief Runs each of the @p commands, returns a result for each
+     *
+     * In the target system, this uses a single shell (see TargetSession)
+     * to which all the commands are submitted at once. All the commands
+     * are run, in order, regardless of failures. The @p timeoutSec
+     * applies to each command individually.
+     *
+     * Plain runCommand() calls in the target (without standard input or
+     * working directory) use that shell as well.
+     */
+    static DLLEXPORT QList< ProcessResult > runCommands( RunLocation location,
+                                                         const QList< QStringList >& commands,
+                                                         std::chrono::seconds timeoutSec = std::chrono::seconds( 0 ) );
+
+    /** @brief Stops the shell in the target (for this thread)
+     *
+     * The shell keeps the target root busy, so this is called
+     * after each job. A new shell is started when needed.
+     */
+    static DLLEXPORT void closeTargetSession();
 
     /** @brief Convenience wrapper for runCommand().
      *  Runs the command in the location specified through the boolean
@@ -160,12 +221,33 @@ public:
     inline ProcessResult targetEnvCommand( const QStringList& args,
                                            const QString& workingPath = QString(),
                                            const QString& stdInput = QString(),
-                                           std::chrono::seconds timeoutSec = std::chrono::seconds( 0 ) )
+                                           std::chrono::seconds timeoutSec = std::chrono::seconds( 0 ),
+                                           const OutputLines::Handler& output = OutputLines::Handler() )
     {
-        return runCommand(
-            m_doChroot ? RunLocation::RunInTarget : RunLocation::RunInHost, args, workingPath, stdInput, timeoutSec );
+        return runCommand( m_doChroot ? RunLocation::RunInTarget : RunLocation::RunInHost,
+                           args,
+                           workingPath,
+                           stdInput,
+                           timeoutSec,
+                           output );
     }
 
+    /** @brief Convenience wrapper for runCommands(), like targetEnvCommand() */
+    inline QList< ProcessResult > targetEnvCommands( const QList< QStringList >& commands,
+                                                     std::chrono::seconds timeoutSec = std::chrono::seconds( 0 ) )
+    {
+        return runCommands( m_doChroot ? RunLocation::RunInTarget : RunLocation::RunInHost, commands, timeoutSec );
+    }
+
+    /** @brief The command line that runs @p args where targetEnvCommand() would
+     *
+     * This is for commands that run outside of the job thread, which must
+     * not read global storage while jobs may be changing it: look up the
+     * command line in the job thread, and later run it with RunInHost.
+     * Returns an empty list if there is no (existing) rootMountPoint.
+     */
+    DLLEXPORT QStringList targetEnvCommandLine( const QStringList& args ) const;
+
     /** @brief Convenience wrapper for targetEnvCommand() which returns only the exit code */
     inline int targetEnvCall( const QStringList& args,
                               const QString& workingPath = QString(),
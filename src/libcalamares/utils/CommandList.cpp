@@ -27,20 +27,49 @@
 #include "utils/Variant.h"
 
 #include <QCoreApplication>
+#include <QFuture>
+#include <QRegularExpression>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrent>
 #include <QVariantList>
 
 namespace CalamaresUtils
 {
 
+void
+CommandLine::setProgressPattern( const QString& pattern )
+{
+    QRegularExpression re( pattern );
+    if ( !re.isValid() || re.captureCount() < 1 )
+    {
+        cWarning() << "Bad progress pattern" << pattern << "for command" << command();
+        return;
+    }
+
+    m_progressParser = [re]( const QString& line ) -> qreal {
+        const auto match = re.match( line );
+        bool ok = false;
+        const qreal percent = match.hasMatch() ? match.captured( 1 ).toDouble( &ok ) : -1.0;
+        return ok ? percent / 100.0 : -1.0;
+    };
+}
+
 static CommandLine
 get_variant_object( const QVariantMap& m )
 {
     QString command = CalamaresUtils::getString( m, "command" );
     qint64 timeout = CalamaresUtils::getInteger( m, "timeout", -1 );
+    QString progress = CalamaresUtils::getString( m, "progress" );
 
     if ( !command.isEmpty() )
     {
-        return CommandLine( command, timeout >= 0 ? std::chrono::seconds( timeout ) : CommandLine::TimeoutNotSet() );
+        CommandLine c( command, timeout >= 0 ? std::chrono::seconds( timeout ) : CommandLine::TimeoutNotSet() );
+        if ( !progress.isEmpty() )
+        {
+            c.setProgressPattern( progress );
+        }
+        return c;
     }
     cWarning() << "Bad CommandLine element" << m;
     return CommandLine();
@@ -57,6 +86,21 @@ get_variant_stringlist( const QVariantList& l )
         {
             retl.append( CommandLine( v.toString(), CommandLine::TimeoutNotSet() ) );
         }
+        else if ( v.type() == QVariant::Map && v.toMap().contains( "parallel" ) )
+        {
+            const QVariantMap m = v.toMap();
+            const QVariant parallel = m.value( "parallel" );
+            const int limit = int( CalamaresUtils::getInteger( m, "limit", 0 ) );
+            // The position in the list is a fine group id, since only
+            // neighbouring commands need to tell groups apart.
+            const int group = int( count ) + 1;
+            for ( auto command : get_variant_stringlist( parallel.type() == QVariant::List ? parallel.toList()
+                                                                                           : QVariantList { parallel } ) )
+            {
+                command.setGroup( group, qMax( 0, limit ) );
+                retl.append( command );
+            }
+        }
         else if ( v.type() == QVariant::Map )
         {
             auto command( get_variant_object( v.toMap() ) );
@@ -100,6 +144,10 @@ CommandList::CommandList::CommandList( const QVariant& v, bool doChroot, std::ch
     {
         append( v.toString() );
     }
+    else if ( v.type() == QVariant::Map && v.toMap().contains( "parallel" ) )
+    {
+        append( get_variant_stringlist( QVariantList { v } ) );
+    }
     else if ( v.type() == QVariant::Map )
     {
         auto c( get_variant_object( v.toMap() ) );
@@ -128,8 +176,44 @@ findInCommands( const CommandList& l, const QString& needle )
     return false;
 }
 
+/** @brief Substitutes @p root and @p user into command @p c
+ *
+ * A leading - (ignore failures) is removed, and sets @p suppressResult.
+ */
+static QString
+processCommand( const CommandLine& c, const QString& root, const QString& user, bool& suppressResult )
+{
+    QString processed_cmd = c.command();
+    processed_cmd.replace( QLatin1String( "@@ROOT@@" ), root ).replace( QLatin1String( "@@USER@@" ), user );
+    suppressResult = false;
+    if ( processed_cmd.startsWith( '-' ) )
+    {
+        suppressResult = true;
+        processed_cmd.remove( 0, 1 );  // Drop the -
+    }
+    return processed_cmd;
+}
+
+/// @brief Is @p r a failure that is not ignored?
+static bool
+isFailure( const ProcessResult& r, bool suppressResult )
+{
+    if ( r.getExitCode() != 0 )
+    {
+        if ( suppressResult )
+        {
+            cDebug() << "Error code" << r.getExitCode() << "ignored by CommandList configuration.";
+        }
+        else
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 Calamares::JobResult
-CommandList::run()
+CommandList::run( const ProgressHandler& progress )
 {
     QLatin1String rootMagic( "@@ROOT@@" );
     QLatin1String userMagic( "@@USER@@" );
@@ -166,39 +250,126 @@ CommandList::run()
     }
     QString user = gs->value( "username" ).toString();  // may be blank if unset
 
-    for ( CommandList::const_iterator i = cbegin(); i != cend(); ++i )
+    const qreal step = count() > 0 ? 1.0 / count() : 1.0;
+    for ( int index = 0; index < count(); )
     {
-        QString processed_cmd = i->command();
-        processed_cmd.replace( rootMagic, root ).replace( userMagic, user );
-        bool suppress_result = false;
-        if ( processed_cmd.startsWith( '-' ) )
+        // Neighbouring commands in the same group run concurrently
+        const int group = at( index ).group();
+        int end = index + 1;
+        while ( group && end < count() && at( end ).group() == group )
         {
-            suppress_result = true;
-            processed_cmd.remove( 0, 1 );  // Drop the -
+            ++end;
+        }
+        if ( end - index > 1 )
+        {
+            Calamares::JobResult r = runGroup( index, end, location, root, user, progress );
+            if ( !r )
+            {
+                return r;
+            }
+            index = end;
+            continue;
         }
 
+        const CommandLine& c = at( index );
+        const qreal done = index * step;
+        bool suppress_result = false;
+        QString processed_cmd = processCommand( c, root, user, suppress_result );
+
         QStringList shell_cmd { "/bin/sh", "-c" };
         shell_cmd << processed_cmd;
 
-        std::chrono::seconds timeout = i->timeout() >= std::chrono::seconds::zero() ? i->timeout() : m_timeout;
-        ProcessResult r = System::runCommand( location, shell_cmd, QString(), QString(), timeout );
-
-        if ( r.getExitCode() != 0 )
-        {
-            if ( suppress_result )
-            {
-                cDebug() << "Error code" << r.getExitCode() << "ignored by CommandList configuration.";
-            }
-            else
+        // Output is always streamed, so that it is logged as it comes,
+        // and long-running chatty commands don't hold all of it in memory.
+        const CommandLine::ProgressParser parser = c.progressParser();
+        auto output = [&progress, &parser, done, step]( const QString& line ) {
+            const qreal p = ( progress && parser ) ? parser( line ) : -1.0;
+            if ( p >= 0.0 )
             {
-                return r.explainProcess( processed_cmd, timeout );
+                progress( done + qBound( 0.0, p, 1.0 ) * step );
             }
+        };
+
+        std::chrono::seconds timeout = c.timeout() >= std::chrono::seconds::zero() ? c.timeout() : m_timeout;
+        ProcessResult r = System::runCommand( location, shell_cmd, QString(), QString(), timeout, output );
+
+        if ( isFailure( r, suppress_result ) )
+        {
+            return r.explainProcess( processed_cmd, timeout );
         }
+        if ( progress )
+        {
+            progress( done + step );
+        }
+        ++index;
     }
 
     return Calamares::JobResult::ok();
 }
 
+Calamares::JobResult
+CommandList::runGroup( int first,
+                       int end,
+                       System::RunLocation location,
+                       const QString& root,
+                       const QString& user,
+                       const ProgressHandler& progress ) const
+{
+    QThreadPool pool;
+    const int limit = at( first ).groupLimit();
+    pool.setMaxThreadCount( limit > 0 ? limit : QThread::idealThreadCount() );
+    cDebug() << "Running" << ( end - first ) << "commands, at most" << pool.maxThreadCount() << "at a time.";
+
+    QStringList commands;
+    QList< bool > suppress;
+    QList< std::chrono::seconds > timeouts;
+    // ProcessResult has no default constructor, which QFuture needs
+    QList< QFuture< QPair< int, QString > > > results;
+    for ( int index = first; index < end; ++index )
+    {
+        const CommandLine& c = at( index );
+        bool suppress_result = false;
+        const QString processed_cmd = processCommand( c, root, user, suppress_result );
+        const std::chrono::seconds timeout = c.timeout() >= std::chrono::seconds::zero() ? c.timeout() : m_timeout;
+
+        commands.append( processed_cmd );
+        suppress.append( suppress_result );
+        timeouts.append( timeout );
+        results.append( QtConcurrent::run( &pool, [=]() -> QPair< int, QString > {
+            ProcessResult r = System::runCommand(
+                location, { "/bin/sh", "-c", processed_cmd }, QString(), QString(), timeout, []( const QString& ) {} );
+            // A session in the target keeps it busy, and this thread
+            // goes back to the pool.
+            System::closeTargetSession();
+            return r;
+        } ) );
+    }
+
+    // Wait for all of them, so that nothing is left running when one fails
+    const qreal step = 1.0 / count();
+    int failure = -1;
+    QList< ProcessResult > processResults;
+    for ( int i = 0; i < results.count(); ++i )
+    {
+        const auto result = results.at( i ).result();
+        processResults.append( ProcessResult( result.first, result.second ) );
+        if ( isFailure( processResults.last(), suppress.at( i ) ) && failure < 0 )
+        {
+            failure = i;
+        }
+        if ( progress )
+        {
+            progress( ( first + i + 1 ) * step );
+        }
+    }
+
+    if ( failure >= 0 )
+    {
+        return processResults.at( failure ).explainProcess( commands.at( failure ), timeouts.at( failure ) );
+    }
+    return Calamares::JobResult::ok();
+}
+
 void
 CommandList::append( const QString& s )
 {
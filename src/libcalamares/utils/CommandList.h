@@ -19,12 +19,14 @@
 #ifndef UTILS_COMMANDLIST_H
 #define UTILS_COMMANDLIST_H
 
+#include "CalamaresUtilsSystem.h"
 #include "Job.h"
 
 #include <QStringList>
 #include <QVariant>
 
 #include <chrono>
+#include <functional>
 
 namespace CalamaresUtils
 {
@@ -32,9 +34,19 @@ namespace CalamaresUtils
 /**
  * Each command can have an associated timeout in seconds. The timeout
  * defaults to 10 seconds. Provide some convenience naming and construction.
+ *
+ * A command can also have a progress parser, which is given each line
+ * of output while the command runs.
  */
 struct CommandLine : public QPair< QString, std::chrono::seconds >
 {
+    /** @brief Reads progress from a line of the command's output
+     *
+     * Returns the progress of the command (from 0 to 1), or a negative
+     * value if the line says nothing about progress.
+     */
+    using ProgressParser = std::function< qreal( const QString& ) >;
+
     static inline constexpr std::chrono::seconds TimeoutNotSet() { return std::chrono::seconds( -1 ); }
 
     /// An invalid command line
@@ -58,6 +70,35 @@ struct CommandLine : public QPair< QString, std::chrono::seconds >
     std::chrono::seconds timeout() const { return second; }
 
     bool isValid() const { return !first.isEmpty(); }
+
+    ProgressParser progressParser() const { return m_progressParser; }
+    void setProgressParser( const ProgressParser& parser ) { m_progressParser = parser; }
+
+    /** @brief Sets a progress parser that matches @p pattern
+     *
+     * The pattern is a regular expression, and its first capture
+     * is the progress in percent. An invalid pattern is ignored.
+     */
+    void setProgressPattern( const QString& pattern );
+
+    /** @brief The parallel group this command belongs to
+     *
+     * Consecutive commands with the same (non-zero) group may run
+     * concurrently; group 0 means the command runs on its own.
+     */
+    int group() const { return m_group; }
+    /// @brief How many commands of the group run at once (0 for the number of CPUs)
+    int groupLimit() const { return m_groupLimit; }
+    void setGroup( int group, int limit )
+    {
+        m_group = group;
+        m_groupLimit = limit;
+    }
+
+private:
+    ProgressParser m_progressParser;
+    int m_group = 0;
+    int m_groupLimit = 0;
 };
 
 /** @brief Abbreviation, used internally. */
@@ -81,7 +122,21 @@ public:
 
     bool doChroot() const { return m_doChroot; }
 
-    Calamares::JobResult run();
+    /// @brief Receives overall progress (from 0 to 1) of run()
+    using ProgressHandler = std::function< void( qreal ) >;
+
+    /** @brief Runs the commands, one after the other
+     *
+     * Output of each command is logged while it runs. If @p progress
+     * is given, it is called after each command, and for every line
+     * of output that the command's progress parser understands.
+     *
+     * The commands of a parallel group run concurrently, and all of
+     * them are run even if one fails; then the first failure (in the
+     * order of the list) is returned. Progress parsers are not used
+     * for commands in a group.
+     */
+    Calamares::JobResult run( const ProgressHandler& progress = ProgressHandler() );
 
     using CommandList_t::at;
     using CommandList_t::cbegin;
@@ -95,6 +150,14 @@ protected:
     void append( const QString& );
 
 private:
+    /// @brief Runs the commands from @p first up to @p end concurrently
+    Calamares::JobResult runGroup( int first,
+                                   int end,
+                                   System::RunLocation location,
+                                   const QString& root,
+                                   const QString& user,
+                                   const ProgressHandler& progress ) const;
+
     bool m_doChroot;
     std::chrono::seconds m_timeout;
 };
@@ -31,6 +31,25 @@ namespace CalamaresUtils
 static QTranslator* s_brandingTranslator = nullptr;
 static QTranslator* s_translator = nullptr;
 static QString s_translatorLocaleName;
+static QString s_brandingTranslationsPrefix;
+
+/** @brief Replaces the @p current translator by @p replacement
+ *
+ * The replacement is installed before the old one is removed, so
+ * there is no moment where the application is without translations
+ * (and widgets would retranslate to the untranslated strings).
+ */
+static void
+swapTranslator( QTranslator*& current, QTranslator* replacement )
+{
+    QCoreApplication::installTranslator( replacement );
+    if ( current )
+    {
+        QCoreApplication::removeTranslator( current );
+        delete current;
+    }
+    current = replacement;
+}
 
 void
 installTranslator( const QLocale& locale, const QString& brandingTranslationsPrefix, QObject* parent )
@@ -51,6 +70,13 @@ installTranslator( const QLocale& locale, const QString& brandingTranslationsPre
         localeName = QStringLiteral( "sr@latin" );
     }
 
+    if ( s_translator && localeName == s_translatorLocaleName
+         && brandingTranslationsPrefix == s_brandingTranslationsPrefix )
+    {
+        // Nothing changes, so don't make everything retranslate
+        return;
+    }
+
     cDebug() << "Looking for translations for" << localeName;
 
     QTranslator* translator = nullptr;
@@ -76,16 +102,10 @@ installTranslator( const QLocale& locale, const QString& brandingTranslationsPre
                 translator->load( brandingTranslationsPrefix + "en" );
             }
 
-            if ( s_brandingTranslator )
-            {
-                QCoreApplication::removeTranslator( s_brandingTranslator );
-                delete s_brandingTranslator;
-            }
-
-            QCoreApplication::installTranslator( translator );
-            s_brandingTranslator = translator;
+            swapTranslator( s_brandingTranslator, translator );
         }
     }
+    s_brandingTranslationsPrefix = brandingTranslationsPrefix;
 
     // Calamares translations
     translator = new QTranslator( parent );
@@ -99,14 +119,7 @@ installTranslator( const QLocale& locale, const QString& brandingTranslationsPre
         translator->load( QString( ":/lang/calamares_en" ) );
     }
 
-    if ( s_translator )
-    {
-        QCoreApplication::removeTranslator( s_translator );
-        delete s_translator;
-    }
-
-    QCoreApplication::installTranslator( translator );
-    s_translator = translator;
+    swapTranslator( s_translator, translator );
 
     s_translatorLocaleName = localeName;
 }
@@ -149,6 +162,18 @@ Retranslator::Retranslator( QObject* parent )
 }
 
 
+void
+Retranslator::retranslate()
+{
+    m_pending = false;
+    for ( const auto& func : m_retranslateFuncList )
+    {
+        func();
+    }
+    emit languageChange();
+}
+
+
 bool
 Retranslator::eventFilter( QObject* obj, QEvent* e )
 {
@@ -156,11 +181,21 @@ Retranslator::eventFilter( QObject* obj, QEvent* e )
     {
         if ( e->type() == QEvent::LanguageChange )
         {
-            foreach ( std::function< void() > func, m_retranslateFuncList )
+            // Widgets that are not visible (e.g. pages other than the current
+            // one) are retranslated when they are shown. This library does
+            // not link to QtWidgets, so ask for the property instead.
+            if ( obj->isWidgetType() && !obj->property( "visible" ).toBool() )
             {
-                func();
+                m_pending = true;
             }
-            emit languageChange();
+            else
+            {
+                retranslate();
+            }
+        }
+        else if ( e->type() == QEvent::Show && m_pending )
+        {
+            retranslate();
         }
     }
     // pass the event on to the base
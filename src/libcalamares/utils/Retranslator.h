@@ -46,7 +46,11 @@ class Retranslator : public QObject
 {
     Q_OBJECT
 public:
-    /// @brief Call @p retranslateFunc when the language changes
+    /** @brief Call @p retranslateFunc when the language changes
+     *
+     * If @p parent is a widget that is hidden when the language changes,
+     * the call is postponed until the widget is shown again.
+     */
     static void attachRetranslator( QObject* parent, std::function< void( void ) > retranslateFunc );
     /// @brief What retranslator belongs to @p parent (may create one)
     static Retranslator* retranslatorFor( QObject* parent );
@@ -63,7 +67,11 @@ protected:
 private:
     explicit Retranslator( QObject* parent );
 
+    /// @brief Calls all the retranslate functions and emits languageChange()
+    void retranslate();
+
     QList< std::function< void( void ) > > m_retranslateFuncList;
+    bool m_pending = false;  ///< Language changed while the (widget) parent was hidden
 };
 
 
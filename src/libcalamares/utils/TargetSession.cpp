@@ -0,0 +1,283 @@
+/* === This file is part of Calamares - <https://github.com/calamares> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Calamares is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Calamares is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Calamares. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TargetSession.h"
+
+#include "Logger.h"
+
+#include <QElapsedTimer>
+#include <QProcess>
+#include <QUuid>
+
+#include <signal.h>
+#include <sys/types.h>
+
+namespace CalamaresUtils
+{
+
+/// @brief Quotes @p s for the shell, as a single word
+static QByteArray
+shellQuote( const QString& s )
+{
+    QByteArray b = s.toLocal8Bit();
+    b.replace( '\'', "'\\''" );
+    return '\'' + b + '\'';
+}
+
+/** @brief Finds a status line @p token <number> newline in @p buffer
+ *
+ * Returns the position of the status line, or -1 if there is no
+ * (complete) status line. Sets @p length to the length of the whole
+ * status line and @p value to the number in it.
+ */
+static int
+findStatus( const QByteArray& buffer, const QByteArray& token, int& length, int& value )
+{
+    const int pos = buffer.indexOf( token );
+    if ( pos < 0 )
+    {
+        return -1;
+    }
+    const int eol = buffer.indexOf( '\n', pos + token.length() );
+    if ( eol < 0 )
+    {
+        return -1;
+    }
+    value = buffer.mid( pos + token.length(), eol - pos - token.length() ).toInt();
+    length = eol + 1 - pos;
+    return pos;
+}
+
+TargetSession::TargetSession( const QString& root )
+    : m_root( root )
+    , m_marker( "CALAMARES-" + QUuid::createUuid().toRfc4122().toHex() )
+{
+}
+
+TargetSession::~TargetSession()
+{
+    close();
+}
+
+bool
+TargetSession::isRunning()
+{
+    if ( m_shell && m_shell->state() == QProcess::Running )
+    {
+        return true;
+    }
+    if ( m_failed )
+    {
+        return false;
+    }
+
+    close();
+    m_shell = new QProcess;
+    m_shell->setProcessChannelMode( QProcess::MergedChannels );
+    if ( m_root.isEmpty() )
+    {
+        m_shell->start( QStringLiteral( "/bin/sh" ), QStringList() );
+    }
+    else
+    {
+        m_shell->start( QStringLiteral( "chroot" ), { m_root, QStringLiteral( "/bin/sh" ) } );
+    }
+
+    // chroot itself may start, but then fail to run the shell,
+    // so wait until the shell says something.
+    const QByteArray ready = m_marker + ":ready\n";
+    m_shell->write( "printf '%s:ready\\n' " + m_marker + '\n' );
+    QElapsedTimer timer;
+    timer.start();
+    while ( !m_buffer.contains( ready ) && m_shell->state() == QProcess::Running && timer.elapsed() < 5000 )
+    {
+        m_shell->waitForReadyRead( 100 );
+        m_buffer.append( m_shell->readAll() );
+    }
+    if ( !m_buffer.contains( ready ) )
+    {
+        cWarning() << "Could not start shell in" << ( m_root.isEmpty() ? QStringLiteral( "/" ) : m_root );
+        cDebug() << Logger::SubEntry << "Output:" << m_buffer;
+        close();
+        m_failed = true;
+        return false;
+    }
+    m_buffer.clear();
+    return true;
+}
+
+void
+TargetSession::close()
+{
+    if ( m_shell )
+    {
+        m_shell->closeWriteChannel();
+        if ( !m_shell->waitForFinished( 1000 ) )
+        {
+            m_shell->kill();
+            m_shell->waitForFinished( 1000 );
+        }
+        delete m_shell;
+        m_shell = nullptr;
+    }
+    m_buffer.clear();
+}
+
+bool
+TargetSession::submit( const QStringList& args )
+{
+    if ( args.isEmpty() || !isRunning() )
+    {
+        return false;
+    }
+
+    // Run the command as a background child of the shell, so that
+    // it cannot change the shell and can be killed by pid on timeout.
+    // The program is exec'd through env, like chroot would, so that it
+    // is looked up in PATH and never replaced by a shell builtin
+    // (echo, printf, test ..). The status lines start with a newline,
+    // in case the command output does not end with one.
+    QByteArray script( "exec env " );
+    for ( const auto& a : args )
+    {
+        script.append( shellQuote( a ) ).append( ' ' );
+    }
+    script.append( "</dev/null 2>&1 &\n" );
+    script.append( "printf '\\n%s:pid:%d\\n' " + m_marker + " $!\n" );
+    script.append( "wait $!\n" );
+    script.append( "printf '\\n%s:exit:%d\\n' " + m_marker + " $?\n" );
+
+    // Written out while waiting for output, in collect()
+    return m_shell->write( script ) == script.size();
+}
+
+ProcessResult
+TargetSession::collect( std::chrono::seconds timeout, OutputLines* lines )
+{
+    const QByteArray pidToken = '\n' + m_marker + ":pid:";
+    const QByteArray exitToken = '\n' + m_marker + ":exit:";
+
+    QElapsedTimer timer;
+    timer.start();
+    qint64 limit = timeout > std::chrono::seconds::zero() ? std::chrono::milliseconds( timeout ).count() : -1;
+    int pid = 0;
+    bool timedOut = false;
+    // When streaming, the newline that ends the output passed on so far
+    // stays in the buffer, since the status lines start with one.
+    bool keptNewline = false;
+
+    while ( m_shell )
+    {
+        int length = 0;
+        int value = 0;
+        int pos = -1;
+        // The first pid in the buffer belongs to this command
+        if ( !pid && ( pos = findStatus( m_buffer, pidToken, length, value ) ) >= 0 )
+        {
+            pid = value;
+            m_buffer.remove( pos, length );
+            keptNewline = keptNewline && pos > 0;
+        }
+        if ( ( pos = findStatus( m_buffer, exitToken, length, value ) ) >= 0 )
+        {
+            QString output;
+            if ( lines )
+            {
+                const int skip = ( keptNewline && pos > 0 ) ? 1 : 0;
+                lines->append( m_buffer.mid( skip, pos - skip ) );
+                lines->finish();
+                output = lines->output();
+            }
+            else
+            {
+                output = QString::fromLocal8Bit( m_buffer.left( pos ) ).trimmed();
+            }
+            m_buffer.remove( 0, pos + length );
+            if ( timedOut )
+            {
+                cWarning().noquote().nospace() << "Timed out. Output so far:\n" << output;
+                return ProcessResult::Code::TimedOut;
+            }
+            return ProcessResult( value, output );
+        }
+
+        // Pass on complete lines; a status line that is not complete
+        // yet comes after the last newline, so it stays in the buffer.
+        const int eol = lines ? m_buffer.lastIndexOf( '\n' ) : -1;
+        if ( eol > 0 )
+        {
+            const int skip = keptNewline ? 1 : 0;
+            lines->append( m_buffer.mid( skip, eol + 1 - skip ) );
+            m_buffer.remove( 0, eol );
+            keptNewline = true;
+        }
+
+        if ( m_shell->state() != QProcess::Running )
+        {
+            cWarning() << "Shell in" << m_root << "has stopped.";
+            close();
+            return ProcessResult::Code::Crashed;
+        }
+        if ( limit >= 0 && timer.elapsed() >= limit )
+        {
+            if ( timedOut || pid <= 0 )
+            {
+                // Even killing it didn't help, give up on this shell
+                close();
+                return ProcessResult::Code::TimedOut;
+            }
+            ::kill( pid, SIGKILL );
+            timedOut = true;
+            limit = 5000;
+            timer.restart();
+        }
+
+        m_shell->waitForReadyRead( limit >= 0 ? int( qMax( qint64( 1 ), limit - timer.elapsed() ) ) : -1 );
+        m_buffer.append( m_shell->readAll() );
+    }
+    return ProcessResult::Code::Crashed;
+}
+
+ProcessResult
+TargetSession::run( const QStringList& args, std::chrono::seconds timeout, OutputLines* lines )
+{
+    if ( !submit( args ) )
+    {
+        return ProcessResult::Code::FailedToStart;
+    }
+    return collect( timeout, lines );
+}
+
+QList< ProcessResult >
+TargetSession::run( const QList< QStringList >& commands, std::chrono::seconds timeout )
+{
+    QList< bool > submitted;
+    for ( const auto& args : commands )
+    {
+        submitted.append( submit( args ) );
+    }
+
+    QList< ProcessResult > results;
+    for ( bool ok : submitted )
+    {
+        results.append( ok ? collect( timeout ) : ProcessResult( ProcessResult::Code::FailedToStart ) );
+    }
+    return results;
+}
+
+}  // namespace CalamaresUtils
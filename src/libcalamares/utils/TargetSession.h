@@ -0,0 +1,112 @@
+/* === This file is part of Calamares - <https://github.com/calamares> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Calamares is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Calamares is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Calamares. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UTILS_TARGETSESSION_H
+#define UTILS_TARGETSESSION_H
+
+#include "CalamaresUtilsSystem.h"
+#include "DllMacro.h"
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include <chrono>
+
+class QProcess;
+
+namespace CalamaresUtils
+{
+
+/** @brief A long-lived shell for running commands in the target system
+ *
+ * Running a command in the target with System::runCommand() starts
+ * `chroot` for every command. A session starts `chroot <root> /bin/sh`
+ * once and then feeds it commands over a pipe; each command is run
+ * by that shell as a child process, and its exit code and (merged)
+ * output are read back. Commands can be submitted in a batch, which
+ * writes them all to the shell at once.
+ *
+ * A session is tied to the thread that created it. With an empty
+ * root, the shell runs in the host system (which is useful for tests).
+ *
+ * Commands get no standard input and run in the root of the target;
+ * use System::runCommand() for anything else.
+ */
+class DLLEXPORT TargetSession
+{
+public:
+    explicit TargetSession( const QString& root );
+    ~TargetSession();
+
+    TargetSession( const TargetSession& ) = delete;
+    TargetSession& operator=( const TargetSession& ) = delete;
+
+    QString root() const { return m_root; }
+
+    /** @brief Is the shell running?
+     *
+     * Starts the shell if it is not running yet. Returns @c false if
+     * it cannot be started, and then the caller should fall back to
+     * running commands individually.
+     */
+    bool isRunning();
+
+    /** @brief Run @p args (program and arguments) in the session
+     *
+     * If the command is not finished within @p timeout (if non-zero),
+     * it is killed and ProcessResult::Code::TimedOut is returned.
+     * If the session fails, ProcessResult::Code::Crashed is returned.
+     * Note that a command killed by a signal reports 128 + the signal
+     * number as exit code, as the shell does.
+     *
+     * If @p lines is given, output is passed to it while the command
+     * runs, and the result holds only the output that @p lines keeps.
+     */
+    ProcessResult run( const QStringList& args,
+                       std::chrono::seconds timeout = std::chrono::seconds( 0 ),
+                       OutputLines* lines = nullptr );
+
+    /** @brief Run all of the @p commands, returns a result for each
+     *
+     * All the commands are run, in order, regardless of failures.
+     * The @p timeout applies to each command individually.
+     */
+    QList< ProcessResult > run( const QList< QStringList >& commands,
+                                std::chrono::seconds timeout = std::chrono::seconds( 0 ) );
+
+    /// @brief Stops the shell (it is started again if needed)
+    void close();
+
+private:
+    /// @brief Writes the shell script that runs @p args to the shell
+    bool submit( const QStringList& args );
+    /// @brief Reads the result of the next submitted command
+    ProcessResult collect( std::chrono::seconds timeout, OutputLines* lines = nullptr );
+
+    QString m_root;
+    QByteArray m_marker;
+    QProcess* m_shell = nullptr;
+    QByteArray m_buffer;
+    bool m_failed = false;  // Could not start, don't try again
+};
+
+}  // namespace CalamaresUtils
+
+#endif
@@ -20,9 +20,15 @@
 
 #include "CalamaresUtilsSystem.h"
 #include "Logger.h"
+#include "TargetSession.h"
 #include "UMask.h"
 #include "Yaml.h"
 
+#include "JobExample.h"
+#include "JobQueue.h"
+
+#include <QAtomicInt>
+#include <QSemaphore>
 #include <QTemporaryFile>
 
 #include <QtTest/QtTest>
@@ -147,6 +153,133 @@ LibCalamaresTests::testCommands()
     QVERIFY( r.getOutput().contains( tfn.fileName() ) );
 }
 
+void
+LibCalamaresTests::testTargetSession()
+{
+    using CalamaresUtils::ProcessResult;
+    using CalamaresUtils::TargetSession;
+
+    // An empty root runs the shell in the host
+    TargetSession session( QString() );
+    QVERIFY( session.isRunning() );
+
+    auto r = session.run( { "/bin/echo", "it's a test" } );
+    QCOMPARE( r.getExitCode(), 0 );
+    QCOMPARE( r.getOutput(), QStringLiteral( "it's a test" ) );
+
+    // Output without newline, exit code, stderr
+    r = session.run( { "/bin/sh", "-c", "printf partial; echo error >&2; exit 3" } );
+    QCOMPARE( r.getExitCode(), 3 );
+    QVERIFY( r.getOutput().contains( "partial" ) );
+    QVERIFY( r.getOutput().contains( "error" ) );
+
+    // Builtins don't change the shell, and commands get no stdin
+    session.run( { "cd", "/tmp" } );
+    r = session.run( { "/bin/pwd" } );
+    QVERIFY( r.getOutput() != QStringLiteral( "/tmp" ) );
+    QCOMPARE( session.run( { "/bin/cat" } ).getExitCode(), 0 );
+
+    QCOMPARE( session.run( { "/no/such/program" } ).getExitCode(), 127 );
+    QCOMPARE( session.run( QStringList() ).getExitCode(), int( ProcessResult::Code::FailedToStart ) );
+
+    // Batches return a result for each command, in order
+    const QList< QStringList > commands { { "/bin/echo", "one" }, { "/bin/false" }, { "/bin/echo", "three" } };
+    const auto results = session.run( commands );
+    QCOMPARE( results.count(), 3 );
+    QCOMPARE( results.at( 0 ).getOutput(), QStringLiteral( "one" ) );
+    QCOMPARE( results.at( 1 ).getExitCode(), 1 );
+    QCOMPARE( results.at( 2 ).getOutput(), QStringLiteral( "three" ) );
+
+    // The command is killed, but the session continues
+    r = session.run( { "/bin/sleep", "30" }, std::chrono::seconds( 1 ) );
+    QCOMPARE( r.getExitCode(), int( ProcessResult::Code::TimedOut ) );
+    QVERIFY( session.isRunning() );
+    QCOMPARE( session.run( { "/bin/echo", "after" } ).getOutput(), QStringLiteral( "after" ) );
+
+    // Programs are exec'd, as chroot does, not replaced by the shell's
+    // builtins (dash's echo does not know -e, for instance).
+    const QList< QStringList > programs { { "echo", "-e", "a\\tb" }, { "printf", "%s-%s\\n", "one", "two" } };
+    for ( const auto& p : programs )
+    {
+        QProcess direct;
+        direct.start( p.first(), p.mid( 1 ) );
+        QVERIFY( direct.waitForFinished() );
+        const QString expected = QString::fromLocal8Bit( direct.readAllStandardOutput() ).trimmed();
+        QCOMPARE( session.run( p ).getOutput().trimmed(), expected );
+    }
+}
+
+namespace
+{
+/// @brief Job that runs the given function
+class FunctionJob : public Calamares::NamedJob
+{
+public:
+    FunctionJob( const QString& name, const std::function< Calamares::JobResult() >& f )
+        : NamedJob( name )
+        , m_f( f )
+    {
+    }
+
+    Calamares::JobResult exec() override { return m_f(); }
+
+private:
+    std::function< Calamares::JobResult() > m_f;
+};
+}  // namespace
+
+void
+LibCalamaresTests::testBackgroundJobs()
+{
+    Logger::setupLogLevel( Logger::LOGDEBUG );
+
+    Calamares::JobQueue queue;
+    // The background work and the users job wait for each other (for a
+    // bounded time), so they can only both get through if they overlap.
+    QSemaphore backgroundStarted;
+    QSemaphore usersRan;
+    QAtomicInt backgroundDone( 0 );
+    QAtomicInt backgroundWaited( 0 );
+    QAtomicInt overlapped( 0 );
+    QAtomicInt bootloaderRan( 0 );
+
+    queue.enqueue( QStringLiteral( "initcpio" ),
+                   { Calamares::job_ptr( new FunctionJob( "initcpio", [&]() {
+                       queue.startBackground( "wait", { "bootloader" }, [&]() {
+                           backgroundStarted.release();
+                           backgroundWaited.store( usersRan.tryAcquire( 1, 5000 ) ? 1 : 0 );
+                           backgroundDone.store( 1 );
+                           return Calamares::JobResult::error( "Background failure", "It waited" );
+                       } );
+                       return Calamares::JobResult::ok();
+                   } ) ) } );
+    queue.enqueue( QStringLiteral( "users" ), { Calamares::job_ptr( new FunctionJob( "users", [&]() {
+                       const bool started = backgroundStarted.tryAcquire( 1, 5000 );
+                       overlapped.store( ( started && !backgroundDone.load() ) ? 1 : 0 );
+                       usersRan.release();
+                       return Calamares::JobResult::ok();
+                   } ) ) } );
+    queue.enqueue( QStringLiteral( "bootloader" ), { Calamares::job_ptr( new FunctionJob( "bootloader", [&]() {
+                       bootloaderRan.store( 1 );
+                       return Calamares::JobResult::ok();
+                   } ) ) } );
+
+    QSignalSpy failed( &queue, &Calamares::JobQueue::failed );
+    QSignalSpy finished( &queue, &Calamares::JobQueue::finished );
+    queue.start();
+    QVERIFY( finished.wait( 15000 ) );
+
+    // The users job ran while the background work did, and the failure
+    // of the background work stopped the queue before bootloader.
+    QCOMPARE( overlapped.load(), 1 );
+    QCOMPARE( backgroundWaited.load(), 1 );
+    QCOMPARE( backgroundDone.load(), 1 );
+    QCOMPARE( bootloaderRan.load(), 0 );
+    QCOMPARE( failed.count(), 1 );
+    QCOMPARE( failed.at( 0 ).at( 0 ).toString(), QStringLiteral( "Background failure" ) );
+    QCOMPARE( failed.at( 0 ).at( 1 ).toString(), QStringLiteral( "It waited" ) );
+}
+
 void
 LibCalamaresTests::testUmask()
 {
@@ -337,6 +337,21 @@ Branding::image( Branding::ImageEntry imageEntry, const QSize& size ) const
     }
 }
 
+QPixmap
+Branding::imageAsync( Branding::ImageEntry imageEntry,
+                      const QSize& size,
+                      QObject* context,
+                      std::function< void( const QPixmap& ) > ready ) const
+{
+    const auto path = imagePath( imageEntry );
+    if ( path.contains( '/' ) )
+    {
+        return ImageRegistry::instance()->pixmapAsync( path, size, context, std::move( ready ) );
+    }
+    // Icons from the theme are not rendered in the background
+    return image( imageEntry, size );
+}
+
 QPixmap
 Branding::image( const QString& imageName, const QSize& size ) const
 {
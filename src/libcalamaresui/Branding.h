@@ -29,6 +29,8 @@
 #include <QObject>
 #include <QStringList>
 
+#include <functional>
+
 namespace YAML
 {
 class Node;
@@ -136,6 +138,17 @@ public:
     QString styleString( Branding::StyleEntry styleEntry ) const;
     QString imagePath( Branding::ImageEntry imageEntry ) const;
     QPixmap image( Branding::ImageEntry imageEntry, const QSize& size ) const;
+    /** @brief Like image(), but does not wait for SVG rendering
+     *
+     * Returns a placeholder for an SVG image file that is not in the
+     * cache yet, and calls @p ready with the real pixmap once it is
+     * rendered, unless @p context is destroyed first.
+     * See ImageRegistry::pixmapAsync().
+     */
+    QPixmap imageAsync( Branding::ImageEntry imageEntry,
+                        const QSize& size,
+                        QObject* context,
+                        std::function< void( const QPixmap& ) > ready ) const;
 
     /** @brief Look up an image in the branding directory or as an icon
      *
@@ -40,6 +40,7 @@
 #include <QQmlEngine>
 #include <QQuickItem>
 #include <QQuickWidget>
+#include <QTimer>
 #include <QVBoxLayout>
 
 /** @brief Calls the QML method @p method()
@@ -82,6 +83,9 @@ ExecutionViewStep::ExecutionViewStep( QObject* parent )
     , m_qmlShow( new QQuickWidget )
     , m_qmlComponent( nullptr )
     , m_qmlObject( nullptr )
+    , m_progressTimer( new QTimer( this ) )
+    , m_progressPending( false )
+    , m_progressPercent( 0.0 )
 {
     QVBoxLayout* layout = new QVBoxLayout( m_widget );
     QVBoxLayout* innerLayout = new QVBoxLayout;
@@ -106,7 +110,16 @@ ExecutionViewStep::ExecutionViewStep( QObject* parent )
         cDebug() << "QML load on startup, API 2.";
         loadQmlV2();
     }
+    else
+    {
+        // The API 1 show starts when loaded, so only compile it ahead of time
+        connect( ViewManager::instance(), &ViewManager::currentStepChanged, this, &ExecutionViewStep::preloadQmlV1 );
+    }
 
+    // Jobs may report progress far more often than is useful to show,
+    // so the progress bar and label are updated at most 25 times per second.
+    m_progressTimer->setInterval( 40 );
+    connect( m_progressTimer, &QTimer::timeout, this, &ExecutionViewStep::showProgress );
     connect( JobQueue::instance(), &JobQueue::progress, this, &ExecutionViewStep::updateFromJobQueue );
 #if QT_VERSION >= QT_VERSION_CHECK( 5, 10, 0 )
     CALAMARES_RETRANSLATE( m_qmlShow->engine()->retranslate(); )
@@ -179,6 +192,28 @@ ExecutionViewStep::loadQmlV2()
     }
 }
 
+void
+ExecutionViewStep::preloadQmlV1()
+{
+    // Start compiling when the step before this one (usually the summary) is shown
+    ViewManager* vm = ViewManager::instance();
+    if ( m_qmlComponent || vm->viewSteps().indexOf( this ) != vm->currentStepIndex() + 1 )
+    {
+        return;
+    }
+    disconnect( vm, &ViewManager::currentStepChanged, this, &ExecutionViewStep::preloadQmlV1 );
+
+    const QString path = Calamares::Branding::instance()->slideshowPath();
+    if ( !path.isEmpty() )
+    {
+        cDebug() << "QML preload, API 1.";
+        // The engine keeps the compiled type, so setSource() on activation
+        // does not have to compile it again. Nothing is created from it here.
+        m_qmlComponent = new QQmlComponent(
+            m_qmlShow->engine(), QUrl::fromLocalFile( path ), QQmlComponent::CompilationMode::Asynchronous, this );
+    }
+}
+
 /// @brief State-change of the slideshow, for changeSlideShowState()
 enum class Slideshow
 {
@@ -284,7 +319,7 @@ ExecutionViewStep::onActivate()
                     j->setEmergency( true );
                 }
             }
-            queue->enqueue( jl );
+            queue->enqueue( module->name(), jl );
         }
     }
 
@@ -309,8 +344,31 @@ ExecutionViewStep::appendJobModuleInstanceKey( const QString& instanceKey )
 void
 ExecutionViewStep::updateFromJobQueue( qreal percent, const QString& message )
 {
-    m_progressBar->setValue( int( percent * m_progressBar->maximum() ) );
-    m_label->setText( message );
+    m_progressPercent = percent;
+    m_progressMessage = message;
+    m_progressPending = true;
+    if ( !m_progressTimer->isActive() )
+    {
+        // Show the first update right away, then at most one per interval
+        showProgress();
+        m_progressTimer->start();
+    }
+}
+
+void
+ExecutionViewStep::showProgress()
+{
+    if ( !m_progressPending )
+    {
+        m_progressTimer->stop();
+        return;
+    }
+    m_progressPending = false;
+    m_progressBar->setValue( int( m_progressPercent * m_progressBar->maximum() ) );
+    if ( m_label->text() != m_progressMessage )
+    {
+        m_label->setText( m_progressMessage );
+    }
 }
 
 void
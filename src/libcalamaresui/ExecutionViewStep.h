@@ -30,6 +30,7 @@ class QProgressBar;
 class QQmlComponent;
 class QQuickItem;
 class QQuickWidget;
+class QTimer;
 
 namespace Calamares
 {
@@ -62,19 +63,26 @@ public:
 
 public slots:
     void loadQmlV2Complete();
+    void preloadQmlV1();  ///< Compiles the API 1 slideshow, before it is shown
 
 private:
     QWidget* m_widget;
     QProgressBar* m_progressBar;
     QLabel* m_label;
     QQuickWidget* m_qmlShow;
-    QQmlComponent* m_qmlComponent;
+    QQmlComponent* m_qmlComponent;  ///< API 2: the show; API 1: compiled ahead of time
     QQuickItem* m_qmlObject;  ///< The actual show
 
+    QTimer* m_progressTimer;
+    bool m_progressPending;  ///< Progress was reported, but not yet shown
+    qreal m_progressPercent;
+    QString m_progressMessage;
+
     QStringList m_jobInstanceKeys;
 
     void loadQmlV2();  ///< Loads the slideshow QML (from branding) for API version 2
     void updateFromJobQueue( qreal percent, const QString& message );
+    void showProgress();  ///< Shows the most recently reported progress
 };
 
 }  // namespace Calamares
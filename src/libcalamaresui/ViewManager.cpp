@@ -165,7 +165,7 @@ ViewManager::addViewStep( ViewStep* step )
     // If this is the first inserted view step, update status of "Next" button
     if ( m_steps.count() == 1 )
     {
-        m_next->setEnabled( step->isNextEnabled() );
+        updateNextEnabled( step->isNextEnabled() );
     }
 }
 
@@ -188,13 +188,18 @@ ViewManager::insertViewStep( int before, ViewStep* step )
         {
             if ( vs == m_steps.at( m_currentStep ) )
             {
-                m_next->setEnabled( status );
+                updateNextEnabled( status );
             }
         }
     } );
 
     m_stack->setCurrentIndex( 0 );
-    step->widget()->setFocus();
+    // Steps appended while the first page is already visible
+    // should not steal the focus from it.
+    if ( before == 0 )
+    {
+        step->widget()->setFocus();
+    }
 }
 
 
@@ -386,7 +391,7 @@ ViewManager::next()
 
     if ( m_currentStep < m_steps.count() )
     {
-        m_next->setEnabled( !executing && m_steps.at( m_currentStep )->isNextEnabled() );
+        updateNextEnabled( !executing && m_steps.at( m_currentStep )->isNextEnabled() );
         m_back->setEnabled( !executing && m_steps.at( m_currentStep )->isBackEnabled() );
     }
 
@@ -466,7 +471,7 @@ ViewManager::back()
         return;
     }
 
-    m_next->setEnabled( m_steps.at( m_currentStep )->isNextEnabled() );
+    updateNextEnabled( m_steps.at( m_currentStep )->isNextEnabled() );
     m_back->setEnabled( m_steps.at( m_currentStep )->isBackEnabled() );
 
     if ( m_currentStep == 0 && m_steps.first()->isAtBeginning() )
@@ -519,4 +524,24 @@ ViewManager::updateCancelEnabled( bool enabled )
     emit cancelEnabled( enabled );
 }
 
+void
+ViewManager::updateNextEnabled( bool enabled )
+{
+    m_next->setEnabled( enabled && !m_modulesLoading );
+}
+
+void
+ViewManager::setModulesLoading( bool loading )
+{
+    m_modulesLoading = loading;
+    if ( m_currentStep >= 0 && m_currentStep < m_steps.count() )
+    {
+        updateNextEnabled( m_steps.at( m_currentStep )->isNextEnabled() );
+    }
+    else
+    {
+        m_next->setEnabled( false );
+    }
+}
+
 }  // namespace Calamares
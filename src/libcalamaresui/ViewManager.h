@@ -118,6 +118,13 @@ public slots:
      */
     void onInitFailed( const QStringList& modules );
 
+    /** @brief Tells the ViewManager that modules are still being loaded.
+     *
+     * While @p loading is true, the "Next" button stays disabled,
+     * since the following view steps may not exist yet.
+     */
+    void setModulesLoading( bool loading );
+
 signals:
     void currentStepChanged();
     void enlarge( QSize enlarge ) const;  // See ViewStep::enlarge()
@@ -130,6 +137,7 @@ private:
     void insertViewStep( int before, ViewStep* step );
     void updateButtonLabels();
     void updateCancelEnabled( bool enabled );
+    void updateNextEnabled( bool enabled );
 
     bool isAtVeryEnd() const
     {
@@ -141,6 +149,7 @@ private:
 
     ViewStepList m_steps;
     int m_currentStep;
+    bool m_modulesLoading = false;
 
     QWidget* m_widget;
     QStackedWidget* m_stack;
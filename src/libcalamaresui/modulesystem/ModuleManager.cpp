@@ -182,131 +182,163 @@ findCustomInstance( const Settings::InstanceDescriptionList& customInstances, co
 void
 ModuleManager::loadModules()
 {
-    QStringList failedModules = checkDependencies();
-    Settings::InstanceDescriptionList customInstances = Settings::instance()->customModuleInstances();
+    m_failedModules = checkDependencies();
+    m_pendingModules.clear();
+    m_viewStepsAnnounced = false;
 
     const auto modulesSequence
-        = failedModules.isEmpty() ? Settings::instance()->modulesSequence() : Settings::ModuleSequence();
+        = m_failedModules.isEmpty() ? Settings::instance()->modulesSequence() : Settings::ModuleSequence();
     for ( const auto& modulePhase : modulesSequence )
     {
-        ModuleSystem::Action currentAction = modulePhase.first;
-
-        foreach ( const QString& moduleEntry, modulePhase.second )
+        for ( const QString& moduleEntry : modulePhase.second )
         {
-            auto instanceKey = ModuleSystem::InstanceKey::fromString( moduleEntry );
-            if ( !instanceKey.isValid() )
-            {
-                cError() << "Wrong module entry format for module" << moduleEntry;
-                failedModules.append( moduleEntry );
-                continue;
-            }
-
+            m_pendingModules.append( qMakePair( modulePhase.first, moduleEntry ) );
+        }
+    }
 
-            if ( !m_availableDescriptorsByModuleName.contains( instanceKey.module() )
-                    || m_availableDescriptorsByModuleName.value( instanceKey.module() ).isEmpty() )
-            {
-                cError() << "Module" << instanceKey.toString() << "not found in module search paths."
-                            << Logger::DebugList( m_paths );
-                failedModules.append( instanceKey.toString() );
-                continue;
-            }
+    ViewManager::instance()->setModulesLoading( true );
+    QTimer::singleShot( 0, this, &ModuleManager::loadNextModule );
+}
 
-            QString configFileName;
-            if ( instanceKey.isCustom() )
-            {
-                int found = findCustomInstance( customInstances, instanceKey );
+void
+ModuleManager::loadNextModule()
+{
+    if ( !m_pendingModules.isEmpty() )
+    {
+        const auto entry = m_pendingModules.takeFirst();
+        if ( !loadModule( entry.first, entry.second ) )
+        {
+            m_failedModules.append( entry.second );
+        }
 
-                if ( found > -1 )
-                {
-                    configFileName = customInstances[ found ].value( "config" );
-                }
-                else  //ought to be a custom instance, but cannot find instance entry
-                {
-                    cError() << "Custom instance" << moduleEntry << "not found in custom instances section.";
-                    failedModules.append( moduleEntry );
-                    continue;
-                }
-            }
-            else
-            {
-                configFileName = QString( "%1.conf" ).arg( instanceKey.module() );
-            }
+        // As soon as there is a page to show, the window can be shown;
+        // the rest of the modules are loaded one-by-one from the event loop.
+        if ( !m_viewStepsAnnounced && m_failedModules.isEmpty() && !ViewManager::instance()->viewSteps().isEmpty() )
+        {
+            m_viewStepsAnnounced = true;
+            emit viewStepsAvailable();
+        }
+    }
 
-            // So now we can assume that the module entry is at least valid,
-            // that we have a descriptor on hand (and therefore that the
-            // module exists), and that the instance is either default or
-            // defined in the custom instances section.
-            // We still don't know whether the config file for the entry
-            // exists and is valid, but that's the only thing that could fail
-            // from this point on. -- Teo 8/2015
-            Module* thisModule = m_loadedModulesByInstanceKey.value( instanceKey, nullptr );
-            if ( thisModule && !thisModule->isLoaded() )
-            {
-                cError() << "Module" << instanceKey.toString() << "exists but not loaded.";
-                failedModules.append( instanceKey.toString() );
-                continue;
-            }
+    if ( !m_pendingModules.isEmpty() )
+    {
+        QTimer::singleShot( 0, this, &ModuleManager::loadNextModule );
+        return;
+    }
 
-            if ( thisModule && thisModule->isLoaded() )
-            {
-                cDebug() << "Module" << instanceKey.toString() << "already loaded.";
-            }
-            else
-            {
-                thisModule = Module::fromDescriptor( m_availableDescriptorsByModuleName.value( instanceKey.module() ),
-                                                        instanceKey.id(),
-                                                        configFileName,
-                                                        m_moduleDirectoriesByModuleName.value( instanceKey.module() ) );
-                if ( !thisModule )
-                {
-                    cError() << "Module" << instanceKey.toString() << "cannot be created from descriptor" << configFileName;
-                    failedModules.append( instanceKey.toString() );
-                    continue;
-                }
+    if ( !m_failedModules.isEmpty() )
+    {
+        ViewManager::instance()->onInitFailed( m_failedModules );
+        ViewManager::instance()->setModulesLoading( false );
+        emit modulesFailed( m_failedModules );
+    }
+    else
+    {
+        ViewManager::instance()->setModulesLoading( false );
+        emit modulesLoaded();
+    }
+}
 
-                if ( !checkDependencies( *thisModule ) )
-                {
-                    // Error message is already printed
-                    failedModules.append( instanceKey.toString() );
-                    continue;
-                }
+bool
+ModuleManager::loadModule( ModuleSystem::Action currentAction, const QString& moduleEntry )
+{
+    auto instanceKey = ModuleSystem::InstanceKey::fromString( moduleEntry );
+    if ( !instanceKey.isValid() )
+    {
+        cError() << "Wrong module entry format for module" << moduleEntry;
+        return false;
+    }
 
-                // If it's a ViewModule, it also appends the ViewStep to the ViewManager.
-                thisModule->loadSelf();
-                m_loadedModulesByInstanceKey.insert( instanceKey, thisModule );
-                if ( !thisModule->isLoaded() )
-                {
-                    cError() << "Module" << instanceKey.toString() << "loading FAILED.";
-                    failedModules.append( instanceKey.toString() );
-                    continue;
-                }
-            }
+    if ( !m_availableDescriptorsByModuleName.contains( instanceKey.module() )
+         || m_availableDescriptorsByModuleName.value( instanceKey.module() ).isEmpty() )
+    {
+        cError() << "Module" << instanceKey.toString() << "not found in module search paths."
+                 << Logger::DebugList( m_paths );
+        return false;
+    }
 
-            // At this point we most certainly have a pointer to a loaded module in
-            // thisModule. We now need to enqueue jobs info into an EVS.
-            if ( currentAction == ModuleSystem::Action::Exec )
-            {
-                ExecutionViewStep* evs
-                    = qobject_cast< ExecutionViewStep* >( Calamares::ViewManager::instance()->viewSteps().last() );
-                if ( !evs )  // If the last step is not an EVS, we must create it.
-                {
-                    evs = new ExecutionViewStep( ViewManager::instance() );
-                    ViewManager::instance()->addViewStep( evs );
-                }
+    QString configFileName;
+    if ( instanceKey.isCustom() )
+    {
+        const Settings::InstanceDescriptionList customInstances = Settings::instance()->customModuleInstances();
+        int found = findCustomInstance( customInstances, instanceKey );
 
-                evs->appendJobModuleInstanceKey( instanceKey.toString() );
-            }
+        if ( found > -1 )
+        {
+            configFileName = customInstances[ found ].value( "config" );
+        }
+        else  //ought to be a custom instance, but cannot find instance entry
+        {
+            cError() << "Custom instance" << moduleEntry << "not found in custom instances section.";
+            return false;
         }
     }
-    if ( !failedModules.isEmpty() )
+    else
     {
-        ViewManager::instance()->onInitFailed( failedModules );
-        emit modulesFailed( failedModules );
+        configFileName = QString( "%1.conf" ).arg( instanceKey.module() );
+    }
+
+    // So now we can assume that the module entry is at least valid,
+    // that we have a descriptor on hand (and therefore that the
+    // module exists), and that the instance is either default or
+    // defined in the custom instances section.
+    // We still don't know whether the config file for the entry
+    // exists and is valid, but that's the only thing that could fail
+    // from this point on. -- Teo 8/2015
+    Module* thisModule = m_loadedModulesByInstanceKey.value( instanceKey, nullptr );
+    if ( thisModule && !thisModule->isLoaded() )
+    {
+        cError() << "Module" << instanceKey.toString() << "exists but not loaded.";
+        return false;
+    }
+
+    if ( thisModule && thisModule->isLoaded() )
+    {
+        cDebug() << "Module" << instanceKey.toString() << "already loaded.";
     }
     else
     {
-        emit modulesLoaded();
+        thisModule = Module::fromDescriptor( m_availableDescriptorsByModuleName.value( instanceKey.module() ),
+                                             instanceKey.id(),
+                                             configFileName,
+                                             m_moduleDirectoriesByModuleName.value( instanceKey.module() ) );
+        if ( !thisModule )
+        {
+            cError() << "Module" << instanceKey.toString() << "cannot be created from descriptor" << configFileName;
+            return false;
+        }
+
+        if ( !checkDependencies( *thisModule ) )
+        {
+            // Error message is already printed
+            return false;
+        }
+
+        // If it's a ViewModule, it also appends the ViewStep to the ViewManager.
+        thisModule->loadSelf();
+        m_loadedModulesByInstanceKey.insert( instanceKey, thisModule );
+        if ( !thisModule->isLoaded() )
+        {
+            cError() << "Module" << instanceKey.toString() << "loading FAILED.";
+            return false;
+        }
+    }
+
+    // At this point we most certainly have a pointer to a loaded module in
+    // thisModule. We now need to enqueue jobs info into an EVS.
+    if ( currentAction == ModuleSystem::Action::Exec )
+    {
+        ExecutionViewStep* evs
+            = qobject_cast< ExecutionViewStep* >( Calamares::ViewManager::instance()->viewSteps().last() );
+        if ( !evs )  // If the last step is not an EVS, we must create it.
+        {
+            evs = new ExecutionViewStep( ViewManager::instance() );
+            ViewManager::instance()->addViewStep( evs );
+        }
+
+        evs->appendJobModuleInstanceKey( instanceKey.toString() );
     }
+    return true;
 }
 
 void
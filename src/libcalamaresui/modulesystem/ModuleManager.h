@@ -20,11 +20,14 @@
 #ifndef MODULELOADER_H
 #define MODULELOADER_H
 
+#include "modulesystem/Actions.h"
 #include "modulesystem/InstanceKey.h"
 
 #include "Requirement.h"
 
+#include <QList>
 #include <QObject>
+#include <QPair>
 #include <QStringList>
 #include <QVariantMap>
 
@@ -80,6 +83,10 @@ public:
 
     /**
      * @brief loadModules does all of the module loading operation.
+     *
+     * The modules are loaded one at a time from the event loop, so
+     * that the window can be shown (see viewStepsAvailable) while
+     * the later modules are still loading.
      * When this is done, the signal modulesLoaded is emitted.
      * It is recommended to call this from a single-shot QTimer.
      */
@@ -93,6 +100,7 @@ public:
 
 signals:
     void initDone();
+    void viewStepsAvailable();  /// The first view step is loaded, others may follow
     void modulesLoaded();  /// All of the modules were loaded successfully
     void modulesFailed( QStringList );  /// .. or not
     // Below, see RequirementsChecker documentation
@@ -102,6 +110,7 @@ signals:
 
 private slots:
     void doInit();
+    void loadNextModule();  /// Loads one module from m_pendingModules
 
 private:
     /**
@@ -124,11 +133,23 @@ private:
      */
     bool checkDependencies( const Module& );
 
+    /**
+     * Load the module named by @p moduleEntry (an instance key),
+     * and queue its jobs if the @p action is Exec.
+     *
+     * Returns true if the module is loaded.
+     */
+    bool loadModule( ModuleSystem::Action action, const QString& moduleEntry );
+
     QMap< QString, QVariantMap > m_availableDescriptorsByModuleName;
     QMap< QString, QString > m_moduleDirectoriesByModuleName;
     QMap< ModuleSystem::InstanceKey, Module* > m_loadedModulesByInstanceKey;
     const QStringList m_paths;
 
+    QList< QPair< ModuleSystem::Action, QString > > m_pendingModules;
+    QStringList m_failedModules;
+    bool m_viewStepsAnnounced = false;
+
     static ModuleManager* s_instance;
 };
 
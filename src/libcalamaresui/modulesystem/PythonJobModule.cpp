@@ -49,7 +49,10 @@ PythonJobModule::loadSelf()
         return;
     }
 
-    m_job = Calamares::job_ptr( new PythonJob( m_scriptFileName, m_workingPath, m_configurationMap ) );
+    auto* job = new PythonJob( m_scriptFileName, m_workingPath, m_configurationMap );
+    // Compile while the user is busy with the UI, rather than in the exec phase
+    job->prewarm();
+    m_job = Calamares::job_ptr( job );
     m_loaded = true;
 }
 
@@ -64,13 +64,21 @@ PythonQtViewModule::loadSelf()
     {
         if ( PythonQt::self() == nullptr )
         {
-            if ( Py_IsInitialized() )
+            // Python jobs use the interpreter from the job thread, and they
+            // take the GIL when they do; so PythonQt must not keep it.
+            const bool alreadyInitialized = Py_IsInitialized();
+            PyGILState_STATE gil = PyGILState_UNLOCKED;
+            if ( alreadyInitialized )
+            {
+                gil = PyGILState_Ensure();
                 PythonQt::init( PythonQt::IgnoreSiteModule | PythonQt::RedirectStdOut
                                 | PythonQt::PythonAlreadyInitialized );
+            }
             else
             {
                 PythonQt::init();
             }
+            PythonQt::self()->setEnableThreadSupport( true );
 
             PythonQt_QtAll::init();
             cDebug() << "Initializing PythonQt bindings."
@@ -112,6 +120,17 @@ PythonQtViewModule::loadSelf()
             QObject::connect( PythonQt::self(), &PythonQt::pythonStdErr, []( const QString& message ) {
                 cDebug() << "PythonQt ERR>" << message;
             } );
+
+            // With thread support, PythonQt takes the GIL itself when it needs
+            // it. PythonQt::init() leaves it held if it initialized Python.
+            if ( alreadyInitialized )
+            {
+                PyGILState_Release( gil );
+            }
+            else
+            {
+                PyEval_SaveThread();
+            }
         }
 
         QDir workingDir( m_workingPath );
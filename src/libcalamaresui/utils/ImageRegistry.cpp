@@ -25,11 +25,97 @@
 
 #include "ImageRegistry.h"
 
+#include <QCache>
+#include <QFutureWatcher>
 #include <QPainter>
 #include <QSvgRenderer>
+#include <QtConcurrent/QtConcurrentRun>
 #include <qicon.h>
 
-static QHash< QString, QHash< int, QHash< qint64, QPixmap > > > s_cache;
+namespace
+{
+/// @brief Everything that determines what a cached pixmap looks like
+struct CacheKey
+{
+    QString image;
+    int mode;
+    QSize size;
+    qreal opacity;
+    QRgb tint;
+
+    bool operator==( const CacheKey& other ) const
+    {
+        return image == other.image && mode == other.mode && size == other.size
+            && opacity == other.opacity && tint == other.tint;
+    }
+};
+
+uint
+qHash( const CacheKey& key, uint seed = 0 )
+{
+    // Mix each part in (as boost::hash_combine does), so that
+    // different sizes / opacities / tints end up with different hashes.
+    uint h = ::qHash( key.image, seed );
+    for ( uint part : { uint( key.mode ),
+                        uint( key.size.width() ),
+                        uint( key.size.height() ),
+                        ::qHash( key.opacity ),
+                        uint( key.tint ) } )
+    {
+        h ^= part + 0x9e3779b9 + ( h << 6 ) + ( h >> 2 );
+    }
+    return h;
+}
+}  // namespace
+
+/// @brief Memory budget of the cache, in KiB
+static constexpr int cacheBudget = 32 * 1024;
+static QCache< CacheKey, QPixmap > s_cache( cacheBudget );
+
+static CacheKey
+makeKey( const QString& image, const QSize& size, CalamaresUtils::ImageMode mode, qreal opacity, QColor tint )
+{
+    return CacheKey { image, int( mode ), size, opacity, tint.rgba() };
+}
+
+/** @brief Renders the SVG @p image
+ *
+ * This only uses QImage, not QPixmap, so it can run outside of the GUI thread.
+ */
+static QImage
+renderSvg( const QString& image, const QSize& size, qreal opacity, QColor tint )
+{
+    QSvgRenderer svgRenderer( image );
+    QImage p( size.isNull() || size.height() == 0 || size.width() == 0 ? svgRenderer.defaultSize() : size,
+              QImage::Format_ARGB32_Premultiplied );
+    p.fill( Qt::transparent );
+
+    QPainter pixPainter( &p );
+    pixPainter.setOpacity( opacity );
+    svgRenderer.render( &pixPainter );
+    pixPainter.end();
+
+    if ( tint.alpha() > 0 )
+    {
+        QImage resultImage( p.size(), QImage::Format_ARGB32_Premultiplied );
+        QPainter painter( &resultImage );
+        painter.drawImage( 0, 0, p );
+        painter.setCompositionMode( QPainter::CompositionMode_Screen );
+        painter.fillRect( resultImage.rect(), tint );
+        painter.end();
+
+        resultImage.setAlphaChannel( p.alphaChannel() );
+        p = resultImage;
+    }
+
+    return p;
+}
+
+static inline bool
+isSvg( const QString& image )
+{
+    return image.toLower().endsWith( ".svg" );
+}
 
 
 ImageRegistry*
@@ -50,13 +136,6 @@ ImageRegistry::icon( const QString& image, CalamaresUtils::ImageMode mode )
 }
 
 
-qint64
-ImageRegistry::cacheKey( const QSize& size, qreal opacity, QColor tint )
-{
-    return size.width() * 100 + size.height() * 10 + static_cast< qint64 >( opacity * 100.0 ) + tint.value();
-}
-
-
 QPixmap
 ImageRegistry::pixmap( const QString& image,
                        const QSize& size,
@@ -70,58 +149,73 @@ ImageRegistry::pixmap( const QString& image,
         return QPixmap();
     }
 
-    QHash< qint64, QPixmap > subsubcache;
-    QHash< int, QHash< qint64, QPixmap > > subcache;
-
-    if ( s_cache.contains( image ) )
+    const QPixmap* cached = s_cache.object( makeKey( image, size, mode, opacity, tint ) );
+    if ( cached )
     {
-        subcache = s_cache.value( image );
-
-        if ( subcache.contains( mode ) )
-        {
-            subsubcache = subcache.value( mode );
-
-            const qint64 ck = cacheKey( size, opacity, tint );
-            if ( subsubcache.contains( ck ) )
-            {
-                return subsubcache.value( ck );
-            }
-        }
+        return *cached;
     }
 
     // Image not found in cache. Let's load it.
     QPixmap pixmap;
-    if ( image.toLower().endsWith( ".svg" ) )
+    if ( isSvg( image ) )
     {
-        QSvgRenderer svgRenderer( image );
-        QPixmap p( size.isNull() || size.height() == 0 || size.width() == 0 ? svgRenderer.defaultSize() : size );
-        p.fill( Qt::transparent );
+        pixmap = QPixmap::fromImage( renderSvg( image, size, opacity, tint ) );
+    }
+    else
+    {
+        pixmap = QPixmap( image );
+    }
 
-        QPainter pixPainter( &p );
-        pixPainter.setOpacity( opacity );
-        svgRenderer.render( &pixPainter );
-        pixPainter.end();
+    return finishPixmap( pixmap, image, size, mode, opacity, tint );
+}
 
-        if ( tint.alpha() > 0 )
-        {
-            QImage resultImage( p.size(), QImage::Format_ARGB32_Premultiplied );
-            QPainter painter( &resultImage );
-            painter.drawPixmap( 0, 0, p );
-            painter.setCompositionMode( QPainter::CompositionMode_Screen );
-            painter.fillRect( resultImage.rect(), tint );
-            painter.end();
-
-            resultImage.setAlphaChannel( p.toImage().alphaChannel() );
-            p = QPixmap::fromImage( resultImage );
-        }
 
-        pixmap = p;
+QPixmap
+ImageRegistry::pixmapAsync( const QString& image,
+                            const QSize& size,
+                            QObject* context,
+                            std::function< void( const QPixmap& ) > ready,
+                            CalamaresUtils::ImageMode mode,
+                            qreal opacity,
+                            QColor tint )
+{
+    if ( !isSvg( image ) || size.width() < 0 || size.height() < 0 )
+    {
+        return pixmap( image, size, mode, opacity, tint );
     }
-    else
+
+    const QPixmap* cached = s_cache.object( makeKey( image, size, mode, opacity, tint ) );
+    if ( cached )
     {
-        pixmap = QPixmap( image );
+        return *cached;
     }
 
+    auto* watcher = new QFutureWatcher< QImage >( context );
+    QObject::connect( watcher, &QFutureWatcher< QImage >::finished, watcher, [=]() {
+        QPixmap p = finishPixmap( QPixmap::fromImage( watcher->result() ), image, size, mode, opacity, tint );
+        watcher->deleteLater();
+        ready( p );
+    } );
+    watcher->setFuture( QtConcurrent::run( renderSvg, image, size, opacity, tint ) );
+
+    QPixmap placeholder;
+    if ( size.width() > 0 && size.height() > 0 )
+    {
+        placeholder = QPixmap( size );
+        placeholder.fill( Qt::transparent );
+    }
+    return placeholder;
+}
+
+
+QPixmap
+ImageRegistry::finishPixmap( QPixmap pixmap,
+                             const QString& image,
+                             const QSize& size,
+                             CalamaresUtils::ImageMode mode,
+                             qreal opacity,
+                             QColor tint )
+{
     if ( !pixmap.isNull() )
     {
         if ( mode == CalamaresUtils::RoundedCorners )
@@ -145,34 +239,11 @@ ImageRegistry::pixmap( const QString& image,
             }
         }
 
-        putInCache( image, size, mode, opacity, pixmap, tint );
+        // The cost is the size in KiB; anything bigger than the
+        // whole budget is not cached at all.
+        const int cost = qMax( 1, pixmap.width() * pixmap.height() * pixmap.depth() / 8 / 1024 );
+        s_cache.insert( makeKey( image, size, mode, opacity, tint ), new QPixmap( pixmap ), cost );
     }
 
     return pixmap;
 }
-
-
-void
-ImageRegistry::putInCache( const QString& image,
-                           const QSize& size,
-                           CalamaresUtils::ImageMode mode,
-                           qreal opacity,
-                           const QPixmap& pixmap,
-                           QColor tint )
-{
-    QHash< qint64, QPixmap > subsubcache;
-    QHash< int, QHash< qint64, QPixmap > > subcache;
-
-    if ( s_cache.contains( image ) )
-    {
-        subcache = s_cache.value( image );
-        if ( subcache.contains( mode ) )
-        {
-            subsubcache = subcache.value( mode );
-        }
-    }
-
-    subsubcache.insert( cacheKey( size, opacity, tint ), pixmap );
-    subcache.insert( mode, subsubcache );
-    s_cache.insert( image, subcache );
-}
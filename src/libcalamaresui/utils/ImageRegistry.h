@@ -31,6 +31,15 @@
 #include "UiDllMacro.h"
 #include "utils/CalamaresUtilsGui.h"
 
+#include <functional>
+
+class QObject;
+
+/** @brief Loads and caches images, rendering SVGs at the requested size
+ *
+ * The rendered pixmaps are kept in a least-recently-used cache
+ * with a limited memory budget.
+ */
 class UIDLLEXPORT ImageRegistry
 {
 public:
@@ -45,14 +54,31 @@ public:
                     qreal opacity = 1.0,
                     QColor tint = QColor( 0, 0, 0, 0 ) );
 
+    /** @brief Gets a pixmap without waiting for SVG rendering
+     *
+     * If the pixmap is in the cache, or the @p image is not an SVG,
+     * this is the same as pixmap(). Otherwise the SVG is rendered
+     * in a worker thread and a transparent placeholder of the requested
+     * @p size is returned; @p ready is called with the real pixmap
+     * (in the GUI thread) once it is available, unless @p context
+     * is destroyed before then.
+     */
+    QPixmap pixmapAsync( const QString& image,
+                         const QSize& size,
+                         QObject* context,
+                         std::function< void( const QPixmap& ) > ready,
+                         CalamaresUtils::ImageMode mode = CalamaresUtils::Original,
+                         qreal opacity = 1.0,
+                         QColor tint = QColor( 0, 0, 0, 0 ) );
+
 private:
-    qint64 cacheKey( const QSize& size, qreal opacity, QColor tint );
-    void putInCache( const QString& image,
-                     const QSize& size,
-                     CalamaresUtils::ImageMode mode,
-                     qreal opacity,
-                     const QPixmap& pixmap,
-                     QColor tint );
+    /// @brief Scales / rounds a loaded @p pixmap and puts it in the cache
+    QPixmap finishPixmap( QPixmap pixmap,
+                          const QString& image,
+                          const QSize& size,
+                          CalamaresUtils::ImageMode mode,
+                          qreal opacity,
+                          QColor tint );
 };
 
 #endif  // IMAGE_REGISTRY_H
@@ -72,19 +72,21 @@ struct ContextualProcessBinding
         }
     }
 
-    Calamares::JobResult run( const QString& value ) const
+    Calamares::JobResult run( const QString& value,
+                              const CalamaresUtils::CommandList::ProgressHandler& progress
+                              = CalamaresUtils::CommandList::ProgressHandler() ) const
     {
         for ( const auto& c : checks )
         {
             if ( value == c.value() )
             {
-                return c.commands()->run();
+                return c.commands()->run( progress );
             }
         }
 
         if ( wildcard )
         {
-            return wildcard->run();
+            return wildcard->run( progress );
         }
 
         return Calamares::JobResult::ok();
@@ -129,11 +131,16 @@ ContextualProcessJob::exec()
 {
     Calamares::GlobalStorage* gs = Calamares::JobQueue::instance()->globalStorage();
 
+    // Each binding gets an equal share of the progress
+    const qreal step = m_commands.isEmpty() ? 1.0 : 1.0 / m_commands.count();
+    qreal done = 0.0;
     for ( const ContextualProcessBinding* binding : m_commands )
     {
+        auto bindingProgress = [this, done, step]( qreal p ) { emit progress( done + p * step ); };
+        done += step;
         if ( gs->contains( binding->variable ) )
         {
-            Calamares::JobResult r = binding->run( gs->value( binding->variable ).toString() );
+            Calamares::JobResult r = binding->run( gs->value( binding->variable ).toString(), bindingProgress );
             if ( !r )
             {
                 return r;
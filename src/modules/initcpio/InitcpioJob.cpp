@@ -18,6 +18,7 @@
 
 #include "InitcpioJob.h"
 
+#include "JobQueue.h"
 #include "utils/CalamaresUtilsSystem.h"
 #include "utils/Logger.h"
 #include "utils/UMask.h"
@@ -72,9 +73,30 @@ InitcpioJob::exec()
         }
     }
 
+    const QStringList command { "mkinitcpio", "-p", m_kernel };
+    Calamares::JobQueue* queue = Calamares::JobQueue::instance();
+    if ( m_background && queue )
+    {
+        // Other jobs run at the same time, so the (process-wide) umask
+        // can't be changed for this alone: set it in a shell instead.
+        // Global storage can't be read from the background either,
+        // so the command in the target is looked up here.
+        const QStringList commandLine = CalamaresUtils::System::instance()->targetEnvCommandLine(
+            QStringList { "/bin/sh", "-c", "umask 077 && exec \"$@\"", "sh" } + command );
+        if ( !commandLine.isEmpty() )
+        {
+            cDebug() << "Updating initramfs with kernel" << m_kernel << "in the background.";
+            queue->startBackground( QStringLiteral( "mkinitcpio" ), m_joinBefore, [commandLine]() {
+                auto r = CalamaresUtils::System::runCommand(
+                    CalamaresUtils::System::RunLocation::RunInHost, commandLine, QString(), QString() );
+                return r.explainProcess( "mkinitcpio", std::chrono::seconds( 10 ) /* fake timeout */ );
+            } );
+            return Calamares::JobResult::ok();
+        }
+    }
+
     cDebug() << "Updating initramfs with kernel" << m_kernel;
-    auto r = CalamaresUtils::System::instance()->targetEnvCommand(
-        { "mkinitcpio", "-p", m_kernel }, QString(), QString() /* no timeout , 0 */ );
+    auto r = CalamaresUtils::System::instance()->targetEnvCommand( command, QString(), QString() /* no timeout , 0 */ );
     return r.explainProcess( "mkinitcpio", std::chrono::seconds( 10 ) /* fake timeout */ );
 }
 
@@ -103,6 +125,10 @@ InitcpioJob::setConfigurationMap( const QVariantMap& configurationMap )
     }
 
     m_unsafe = CalamaresUtils::getBool( configurationMap, "be_unsafe", false );
+
+    m_background = CalamaresUtils::getBool( configurationMap, "background", false );
+    m_joinBefore = configurationMap.contains( "join_before" ) ? configurationMap.value( "join_before" ).toStringList()
+                                                              : QStringList { "bootloader", "umount" };
 }
 
 CALAMARES_PLUGIN_FACTORY_DEFINITION( InitcpioJobFactory, registerPlugin< InitcpioJob >(); )
@@ -18,6 +18,7 @@
 
 #include "InitramfsJob.h"
 
+#include "JobQueue.h"
 #include "utils/CalamaresUtilsSystem.h"
 #include "utils/Logger.h"
 #include "utils/UMask.h"
@@ -37,7 +38,6 @@ InitramfsJob::prettyName() const
     return tr( "Creating initramfs." );
 }
 
-
 Calamares::JobResult
 InitramfsJob::exec()
 {
@@ -61,9 +61,30 @@ InitramfsJob::exec()
         }
     }
 
-    // And then do the ACTUAL work.
-    auto r = CalamaresUtils::System::instance()->targetEnvCommand(
-        { "update-initramfs", "-k", m_kernel, "-c", "-t" }, QString(), QString() /* no timeout, 0 */ );
+    // And then do the ACTUAL work, possibly while later jobs run.
+    const QStringList command { "update-initramfs", "-k", m_kernel, "-c", "-t" };
+    Calamares::JobQueue* queue = Calamares::JobQueue::instance();
+    if ( m_background && queue )
+    {
+        // Other jobs run at the same time, so the (process-wide) umask
+        // can't be changed for this alone: set it in a shell instead.
+        // Global storage can't be read from the background either,
+        // so the command in the target is looked up here.
+        const QStringList commandLine = CalamaresUtils::System::instance()->targetEnvCommandLine(
+            QStringList { "/bin/sh", "-c", "umask 077 && exec \"$@\"", "sh" } + command );
+        if ( !commandLine.isEmpty() )
+        {
+            cDebug() << Logger::SubEntry << "update-initramfs runs in the background.";
+            queue->startBackground( QStringLiteral( "update-initramfs" ), m_joinBefore, [commandLine]() {
+                auto r = CalamaresUtils::System::runCommand(
+                    CalamaresUtils::System::RunLocation::RunInHost, commandLine, QString(), QString() );
+                return r.explainProcess( "update-initramfs", std::chrono::seconds( 10 ) /* fake timeout */ );
+            } );
+            return Calamares::JobResult::ok();
+        }
+    }
+
+    auto r = CalamaresUtils::System::instance()->targetEnvCommand( command, QString(), QString() /* no timeout, 0 */ );
     return r.explainProcess( "update-initramfs", std::chrono::seconds( 10 ) /* fake timeout */ );
 }
 
@@ -93,6 +114,10 @@ InitramfsJob::setConfigurationMap( const QVariantMap& configurationMap )
     }
 
     m_unsafe = CalamaresUtils::getBool( configurationMap, "be_unsafe", false );
+
+    m_background = CalamaresUtils::getBool( configurationMap, "background", false );
+    m_joinBefore = configurationMap.contains( "join_before" ) ? configurationMap.value( "join_before" ).toStringList()
+                                                              : QStringList { "bootloader", "umount" };
 }
 
 CALAMARES_PLUGIN_FACTORY_DEFINITION( InitramfsJobFactory, registerPlugin< InitramfsJob >(); )
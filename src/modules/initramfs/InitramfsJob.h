@@ -24,6 +24,7 @@
 #include "utils/PluginFactory.h"
 
 #include <QObject>
+#include <QStringList>
 #include <QVariantMap>
 
 class PLUGINDLLEXPORT InitramfsJob : public Calamares::CppJob
@@ -43,6 +44,8 @@ public:
 private:
     QString m_kernel;
     bool m_unsafe = false;
+    bool m_background = false;
+    QStringList m_joinBefore;
 };
 
 CALAMARES_PLUGIN_FACTORY_DECLARATION( InitramfsJobFactory )
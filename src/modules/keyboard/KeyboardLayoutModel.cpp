@@ -71,4 +71,16 @@ KeyboardLayoutModel::init()
     {
         return a.second.description < b.second.description;
     } );
+
+    m_layoutRows.reserve( m_layouts.count() );
+    for ( int i = 0; i < m_layouts.count(); ++i )
+        m_layoutRows.insert( m_layouts.at( i ).first.toLower(), i );
+}
+
+
+QModelIndex
+KeyboardLayoutModel::findLayout( const QString& key ) const
+{
+    const auto it = m_layoutRows.constFind( key.toLower() );
+    return it == m_layoutRows.constEnd() ? QModelIndex() : index( it.value() );
 }
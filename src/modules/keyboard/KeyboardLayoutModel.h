@@ -22,6 +22,7 @@
 #include "keyboardwidget/keyboardglobal.h"
 
 #include <QAbstractListModel>
+#include <QHash>
 #include <QMap>
 #include <QMetaType>
 
@@ -42,10 +43,14 @@ public:
 
     QVariant data( const QModelIndex& index, int role ) const override;
 
+    /// @brief The index of the layout named @p key (case-insensitive), or invalid
+    QModelIndex findLayout( const QString& key ) const;
+
 private:
     void init();
 
     QList< QPair< QString, KeyboardGlobal::KeyboardInfo > > m_layouts;
+    QHash< QString, int > m_layoutRows;  // lower-case key -> row
 };
 
 #endif // KEYBOARDLAYOUTMODEL_H
@@ -255,17 +255,12 @@ KeyboardPage::guessLayout( const QStringList& langParts )
     for ( auto countryPart = langParts.rbegin(); !foundCountryPart && countryPart != langParts.rend(); ++countryPart )
     {
         cDebug() << Logger::SubEntry << "looking for locale part" << *countryPart;
-        for ( int i = 0; i < klm->rowCount(); ++i )
+        QModelIndex idx = klm->findLayout( *countryPart );
+        if ( idx.isValid() )
         {
-            QModelIndex idx = klm->index( i );
-            QString name = idx.isValid() ? idx.data( KeyboardLayoutModel::KeyboardLayoutKeyRole ).toString() : QString();
-            if ( idx.isValid() && ( name.compare( *countryPart, Qt::CaseInsensitive ) == 0 ) )
-            {
-                cDebug() << Logger::SubEntry << "matched" << name;
-                ui->listLayout->setCurrentIndex( idx );
-                foundCountryPart = true;
-                break;
-            }
+            cDebug() << Logger::SubEntry << "matched" << idx.data( KeyboardLayoutModel::KeyboardLayoutKeyRole ).toString();
+            ui->listLayout->setCurrentIndex( idx );
+            foundCountryPart = true;
         }
         if ( foundCountryPart )
         {
@@ -471,6 +466,15 @@ KeyboardPage::onListVariantCurrentItemChanged( QListWidgetItem* current, QListWi
     m_keyboardPreview->setLayout( layout );
     m_keyboardPreview->setVariant( variant );
 
+    // Get the neighbours ready too, for scrolling through the list
+    const int row = ui->listVariant->row( current );
+    for ( int neighbour : { row + 1, row - 1 } )
+    {
+        LayoutItem* item = dynamic_cast< LayoutItem* >( ui->listVariant->item( neighbour ) );
+        if ( item )
+            m_keyboardPreview->prefetch( layout, item->data );
+    }
+
     //emit checkReady();
 
     // Set Xorg keyboard layout
@@ -27,6 +27,9 @@
 
 #include "utils/Logger.h"
 
+#include <QDateTime>
+#include <QFileInfo>
+
 #ifdef Q_OS_FREEBSD
 static const char XKB_FILE[] = "/usr/local/share/X11/xkb/rules/base.lst";
 #else
@@ -34,156 +37,167 @@ static const char XKB_FILE[] = "/usr/share/X11/xkb/rules/base.lst";
 #endif
 
 // The xkb rules file is made of several "sections". Each section
-// starts with a line "! <sectionname>". The static methods here
-// handle individual sections.
+// starts with a line "! <sectionname>". The file is read in one
+// pass, and the parsed sections are kept (untranslated) for as long
+// as the file does not change.
+
+/** @brief The sections of the xkb rules file that are used here */
+struct XkbRules
+{
+    QString path;
+    QDateTime lastModified;
+    qint64 size = -1;
+
+    KeyboardGlobal::ModelsMap models;  // description -> model
+    KeyboardGlobal::LayoutsMap layouts;  // without the "Default" variants
+    QString defaultModelDescription;  // description of pc105
+};
 
-/** @brief Scans a file for a named section
+/** @brief Splits an indented line into its first word and the rest
  *
- * Reads from @p fh incrementally until it finds a section named @p name
- * or hits end-of-file. Returns true if the section is found. The
- * @p name must include the "! " section marker as well.
+ * This does what the regular expression "^\\s+(\\S+)\\s+(\\w.*)$"
+ * used to do: returns false unless @p line is indented and has a
+ * word followed by something starting with a word-character.
  */
-static bool findSection( QFile& fh, const char* name )
+static bool splitEntry( const QString& line, QString& name, QString& rest )
 {
-    while ( !fh.atEnd() )
-    {
-        QByteArray line = fh.readLine();
-        if ( line.startsWith( name ) )
-            return true;
-    }
-    return false;
+    const int length = line.length();
+    int i = 0;
+    while ( i < length && line.at( i ).isSpace() )
+        ++i;
+    if ( i == 0 || i == length )
+        return false;
+
+    const int nameStart = i;
+    while ( i < length && !line.at( i ).isSpace() )
+        ++i;
+    const int nameEnd = i;
+    while ( i < length && line.at( i ).isSpace() )
+        ++i;
+    if ( i == length || !( line.at( i ).isLetterOrNumber() || line.at( i ) == '_' ) )
+        return false;
+
+    name = line.mid( nameStart, nameEnd - nameStart );
+    rest = line.mid( i ).trimmed();
+    return true;
 }
 
-static KeyboardGlobal::ModelsMap parseKeyboardModels( const char* filepath )
+static void parseKeyboardRules( const QByteArray& data, XkbRules& rules )
 {
-    KeyboardGlobal::ModelsMap models;
-
-    QFile fh( filepath );
-    fh.open( QIODevice::ReadOnly );
-
-    if ( !fh.isOpen() )
+    enum class Section
     {
-        cDebug() << "X11 Keyboard model definitions not found!";
-        return models;
-    }
-
-    bool modelsFound = findSection( fh, "! model" );
-    // read the file until the end or until we break the loop
-    while ( modelsFound && !fh.atEnd() )
+        None,
+        Model,
+        Layout,
+        Variant
+    } section = Section::None;
+
+    QString name, rest;
+    for ( const QByteArray& rawLine : data.split( '\n' ) )
     {
-        QByteArray line = fh.readLine();
-
-        // check if we start a new section
-        if ( line.startsWith( '!' ) )
-            break;
-
-        // here we are in the model section, otherwhise we would continue or break
-        QRegExp rx;
-        rx.setPattern( "^\\s+(\\S+)\\s+(\\w.*)\n$" );
-
-        // insert into the model map
-        if ( rx.indexIn( line ) != -1 )
+        if ( rawLine.startsWith( '!' ) )
         {
-            QString modelDesc = rx.cap( 2 );
-            QString model = rx.cap( 1 );
-
-            if ( model == "pc105" )
-                modelDesc += "  -  " + QObject::tr( "Default Keyboard Model" );
-
-            models.insert( modelDesc, model );
+            const QByteArray sectionName = rawLine.mid( 1 ).trimmed();
+            if ( sectionName == "model" )
+                section = Section::Model;
+            else if ( sectionName == "layout" )
+                section = Section::Layout;
+            else if ( sectionName == "variant" )
+                section = Section::Variant;
+            else
+                section = Section::None;
+            continue;
         }
-    }
-
-    return models;
-}
-
-
-KeyboardGlobal::LayoutsMap parseKeyboardLayouts( const char* filepath )
-{
-    KeyboardGlobal::LayoutsMap layouts;
-
-    //### Get Layouts ###//
-
-    QFile fh( filepath );
-    fh.open( QIODevice::ReadOnly );
+        if ( section == Section::None )
+            continue;
 
-    if ( !fh.isOpen() )
-    {
-        cDebug() << "X11 Keyboard layout definitions not found!";
-        return layouts;
-    }
-
-    bool layoutsFound = findSection( fh, "! layout" );
-    // read the file until the end or we break the loop
-    while ( layoutsFound && !fh.atEnd() )
-    {
-        QByteArray line = fh.readLine();
+        if ( !splitEntry( QString::fromUtf8( rawLine ), name, rest ) )
+            continue;
 
-        if ( line.startsWith( '!' ) )
+        switch ( section )
+        {
+        case Section::Model:
+            if ( name == "pc105" )
+                rules.defaultModelDescription = rest;
+            rules.models.insert( rest, name );
             break;
-
-        QRegExp rx;
-        rx.setPattern( "^\\s+(\\S+)\\s+(\\w.*)\n$" );
-
-        // insert into the layout map
-        if ( rx.indexIn( line ) != -1 )
+        case Section::Layout:
+            // The layout may already be there, if a variant named it first
+            rules.layouts[ name ].description = rest;
+            break;
+        case Section::Variant:
         {
-            KeyboardGlobal::KeyboardInfo info;
-            info.description = rx.cap( 2 );
-            info.variants.insert( QObject::tr( "Default" ), "" );
-            layouts.insert( rx.cap( 1 ), info );
+            // The rest is "<layout>: <description>"
+            const int colon = rest.indexOf( ": " );
+            if ( colon <= 0 || rest.leftRef( colon ).contains( ' ' ) )
+                break;
+            const QString layout = rest.left( colon );
+            const QString description = rest.mid( colon + 2 ).trimmed();
+            if ( description.isEmpty() )
+                break;
+
+            auto it = rules.layouts.find( layout );
+            if ( it == rules.layouts.end() )
+            {
+                // Not seen this layout (yet), so use the name for the description
+                it = rules.layouts.insert( layout, KeyboardGlobal::KeyboardInfo() );
+                it->description = layout;
+            }
+            it->variants.insert( description, name );
+            break;
+        }
+        case Section::None:
+            break;
         }
     }
+}
 
-    fh.reset();
-
+/** @brief The parsed rules from @p filepath
+ *
+ * The file is only read again when its size or modification time change.
+ */
+static const XkbRules& keyboardRules( const char* filepath )
+{
+    static XkbRules rules;
 
-    //### Get Variants ###//
+    QFileInfo fi( filepath );
+    if ( rules.path == fi.filePath() && rules.size == fi.size() && rules.lastModified == fi.lastModified() )
+        return rules;
 
-    bool variantsFound = findSection( fh, "! variant" );
-    // read the file until the end or until we break
-    while ( variantsFound && !fh.atEnd() )
+    rules = XkbRules();
+    QFile fh( filepath );
+    if ( !fh.open( QIODevice::ReadOnly ) )
     {
-        QByteArray line = fh.readLine();
-
-        if ( line.startsWith( '!' ) )
-            break;
-
-        QRegExp rx;
-        rx.setPattern( "^\\s+(\\S+)\\s+(\\S+): (\\w.*)\n$" );
-
-        // insert into the variants multimap, if the pattern matches
-        if ( rx.indexIn( line ) != -1 )
-        {
-            if ( layouts.find( rx.cap( 2 ) ) != layouts.end() )
-            {
-                // in this case we found an entry in the multimap, and add the values to the multimap
-                layouts.find( rx.cap( 2 ) ).value().variants.insert( rx.cap( 3 ), rx.cap( 1 ) );
-            }
-            else
-            {
-                // create a new map in the multimap - the value was not found.
-                KeyboardGlobal::KeyboardInfo info;
-                info.description = rx.cap( 2 );
-                info.variants.insert( QObject::tr( "Default" ), "" );
-                info.variants.insert( rx.cap( 3 ), rx.cap( 1 ) );
-                layouts.insert( rx.cap( 2 ), info );
-            }
-        }
+        cDebug() << "X11 Keyboard model and layout definitions not found!";
+        return rules;
     }
 
-    return layouts;
+    parseKeyboardRules( fh.readAll(), rules );
+    rules.path = fi.filePath();
+    rules.size = fi.size();
+    rules.lastModified = fi.lastModified();
+    return rules;
 }
 
 
 KeyboardGlobal::LayoutsMap KeyboardGlobal::getKeyboardLayouts()
 {
-    return parseKeyboardLayouts( XKB_FILE );
+    KeyboardGlobal::LayoutsMap layouts = keyboardRules( XKB_FILE ).layouts;
+    const QString defaultVariant = QObject::tr( "Default" );
+    for ( auto& info : layouts )
+        info.variants.insert( defaultVariant, QString() );
+    return layouts;
 }
 
 
 KeyboardGlobal::ModelsMap KeyboardGlobal::getKeyboardModels()
 {
-    return parseKeyboardModels( XKB_FILE );
+    const XkbRules& rules = keyboardRules( XKB_FILE );
+    KeyboardGlobal::ModelsMap models = rules.models;
+    if ( !rules.defaultModelDescription.isEmpty() )
+    {
+        const QString model = models.take( rules.defaultModelDescription );
+        models.insert( rules.defaultModelDescription + "  -  " + QObject::tr( "Default Keyboard Model" ), model );
+    }
+    return models;
 }
-
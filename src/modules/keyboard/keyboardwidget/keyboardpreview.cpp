@@ -30,6 +30,9 @@ KeyBoardPreview::KeyBoardPreview( QWidget* parent )
     , space( 0 )
     , usable_width( 0 )
     , key_w( 0 )
+    , codesCache( 32 )
+    , ckbcompRunning( false )
+    , ckbcompMissing( false )
 {
     setMinimumSize(700, 191);
 
@@ -71,12 +74,23 @@ void KeyBoardPreview::setLayout(QString _layout) {
 
 void KeyBoardPreview::setVariant(QString _variant) {
     variant = _variant;
+    loadCodes();
+}
+
 
-    if (!loadCodes())
+
+void KeyBoardPreview::prefetch(const QString& _layout, const QString& _variant) {
+    const LayoutVariant key(_layout, _variant);
+    if (_layout.isEmpty() || ckbcompMissing || codesCache.contains(key) || failedKeys.contains(key)
+        || prefetchQueue.contains(key))
         return;
 
-    loadInfo();
-    repaint();
+    // Most recent requests first, and only a handful of them
+    prefetchQueue.prepend(key);
+    while (prefetchQueue.count() > 4)
+        prefetchQueue.removeLast();
+
+    startCkbcomp();
 }
 
 
@@ -101,49 +115,111 @@ void KeyBoardPreview::loadInfo() {
 
 
 
-bool KeyBoardPreview::loadCodes() {
+void KeyBoardPreview::loadCodes() {
     if (layout.isEmpty())
-        return false;
+        return;
 
-    QStringList param;
-    param << "-model" << "pc106" << "-layout" << layout << "-compact";
-    if (!variant.isEmpty())
-        param << "-variant" << variant;
-
-
-    QProcess process;
-    process.setEnvironment(QStringList() << "LANG=C" << "LC_MESSAGES=C");
-    process.start("ckbcomp", param);
-    if (!process.waitForStarted())
-    {
-        cWarning() << "ckbcomp not found , keyboard preview disabled";
-        return false;
+    const QList<Code>* cached = codesCache.object(LayoutVariant(layout, variant));
+    if (cached) {
+        codes = *cached;
+        loadInfo();
+        update();
+        return;
     }
 
-    if (!process.waitForFinished())
-    {
-        cWarning() << "ckbcomp failed, keyboard preview disabled";
-        return false;
+    // The old keys stay visible until ckbcomp is done
+    startCkbcomp();
+}
+
+
+
+void KeyBoardPreview::startCkbcomp() {
+    if (ckbcompRunning || ckbcompMissing)
+        return;
+
+    // The selected layout goes first, then whatever is prefetched
+    LayoutVariant key(layout, variant);
+    if (layout.isEmpty() || codesCache.contains(key) || failedKeys.contains(key)) {
+        key = LayoutVariant();
+        while (!prefetchQueue.isEmpty() && key.first.isEmpty()) {
+            key = prefetchQueue.takeFirst();
+            if (codesCache.contains(key) || failedKeys.contains(key))
+                key = LayoutVariant();
+        }
+        if (key.first.isEmpty())
+            return;
     }
+    prefetchQueue.removeAll(key);
 
-    // Clear codes
-    codes.clear();
+    QStringList param;
+    param << "-model" << "pc106" << "-layout" << key.first << "-compact";
+    if (!key.second.isEmpty())
+        param << "-variant" << key.second;
+
+    QProcess* process = new QProcess(this);
+    process->setEnvironment(QStringList() << "LANG=C" << "LC_MESSAGES=C");
+    connect(process, &QProcess::errorOccurred, this, [this, process](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            cWarning() << "ckbcomp not found , keyboard preview disabled";
+            ckbcompMissing = true;
+            ckbcompRunning = false;
+            prefetchQueue.clear();
+            process->deleteLater();
+        }
+    });
+    connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this,
+            [this, process, key](int exitCode, QProcess::ExitStatus exitStatus) {
+        ckbcompRunning = false;
+        if (exitStatus != QProcess::NormalExit || exitCode != 0) {
+            // Remember the failure, so that the next ckbcomp is for
+            // another (prefetched) layout rather than this one again.
+            cWarning() << "ckbcomp failed for" << key.first << key.second;
+            failedKeys.insert(key);
+        } else {
+            ckbcompFinished(key, process->readAllStandardOutput());
+        }
+        process->deleteLater();
+        startCkbcomp();
+    });
+
+    ckbcompRunning = true;
+    process->start("ckbcomp", param);
+}
+
+
+
+void KeyBoardPreview::ckbcompFinished(const LayoutVariant& key, const QByteArray& output) {
+    codesCache.insert(key, new QList<Code>(parseCodes(output)));
 
-    const QStringList list = QString(process.readAll()).split("\n", QString::SkipEmptyParts);
+    if (key == LayoutVariant(layout, variant)) {
+        codes = *codesCache.object(key);
+        loadInfo();
+        update();
+    }
+}
+
+
+
+QList<KeyBoardPreview::Code> KeyBoardPreview::parseCodes(const QByteArray& output) {
+    QList<Code> result;
+
+    for (const QByteArray& line : output.split('\n')) {
+        if (!line.startsWith("keycode"))
+            continue;
 
-    for (const QString &line : list) {
-        if (!line.startsWith("keycode") || !line.contains('='))
+        const int eq = line.indexOf('=');
+        if (eq < 0)
             continue;
 
-        QStringList split = line.split('=').at(1).trimmed().split(' ');
+        const QList<QByteArray> split = line.mid(eq + 1).trimmed().split(' ');
         if (split.size() < 4)
             continue;
 
         Code code;
-        code.plain = fromUnicodeString(split.at(0));
-        code.shift = fromUnicodeString(split.at(1));
-        code.ctrl = fromUnicodeString(split.at(2));
-        code.alt = fromUnicodeString(split.at(3));
+        code.plain = fromUnicodeString(QString::fromLatin1(split.at(0)));
+        code.shift = fromUnicodeString(QString::fromLatin1(split.at(1)));
+        code.ctrl = fromUnicodeString(QString::fromLatin1(split.at(2)));
+        code.alt = fromUnicodeString(QString::fromLatin1(split.at(3)));
 
         if (code.ctrl == code.plain)
             code.ctrl = "";
@@ -151,10 +227,10 @@ bool KeyBoardPreview::loadCodes() {
         if (code.alt == code.plain)
             code.alt = "";
 
-        codes.append(code);
+        result.append(code);
     }
 
-    return true;
+    return result;
 }
 
 
@@ -24,6 +24,8 @@
 #define KEYBOARDPREVIEW_H
 
 #include <QWidget>
+#include <QCache>
+#include <QPair>
 #include <QRectF>
 #include <QFont>
 #include <QPainter>
@@ -32,6 +34,7 @@
 #include <QColor>
 #include <QPixmap>
 #include <QProcess>
+#include <QSet>
 #include <QString>
 #include <QStringList>
 
@@ -45,6 +48,10 @@ public:
     void setLayout(QString layout);
     void setVariant(QString variant);
 
+    // Loads the key codes for @p layout and @p variant in the background,
+    // so that selecting them later does not have to wait for ckbcomp.
+    void prefetch(const QString& layout, const QString& variant);
+
 private:
     enum KB_TYPE { KB_104, KB_105, KB_106 };
 
@@ -57,19 +64,31 @@ private:
         QString plain, shift, ctrl, alt;
     };
 
+    using LayoutVariant = QPair<QString, QString>;
+
     QString layout, variant;
     QFont lowerFont, upperFont;
     KB* kb, kbList[3];
     QList<Code> codes;
     int space, usable_width, key_w;
 
+    // Key codes of recently used layouts, most-recently-used are kept
+    QCache<LayoutVariant, QList<Code> > codesCache;
+    QList<LayoutVariant> prefetchQueue;
+    // Layouts ckbcomp failed for; they are not tried again
+    QSet<LayoutVariant> failedKeys;
+    bool ckbcompRunning, ckbcompMissing;
+
     void loadInfo();
-    bool loadCodes();
+    void loadCodes();
+    void startCkbcomp();
+    void ckbcompFinished(const LayoutVariant& key, const QByteArray& output);
+    static QList<Code> parseCodes(const QByteArray& output);
     QString regular_text(int index);
     QString shift_text(int index);
     QString ctrl_text(int index);
     QString alt_text(int index);
-    QString fromUnicodeString(QString raw);
+    static QString fromUnicodeString(QString raw);
 
 protected:
     void paintEvent(QPaintEvent* event);
@@ -27,7 +27,6 @@
 #include "JobQueue.h"
 
 #include "geoip/Handler.h"
-#include "network/Manager.h"
 #include "utils/CalamaresUtilsGui.h"
 #include "utils/Logger.h"
 #include "utils/Variant.h"
@@ -87,7 +86,7 @@ LocaleViewStep::fetchGeoIpTimezone()
         m_startingTimezone = m_geoip->get();
         if ( !m_startingTimezone.isValid() )
         {
-            cWarning() << "GeoIP lookup at" << m_geoip->url() << "failed.";
+            cWarning() << "GeoIP lookup from" << m_geoip->count() << "providers failed.";
         }
     }
 }
@@ -216,7 +215,22 @@ LocaleViewStep::setConfigurationMap( const QVariantMap& configurationMap )
         QString style = CalamaresUtils::getString( geoip, "style" );
         QString selector = CalamaresUtils::getString( geoip, "selector" );
 
-        m_geoip = std::make_unique< CalamaresUtils::GeoIP::Handler >( style, url, selector );
+        m_geoip = std::make_unique< CalamaresUtils::GeoIP::MultiHandler >();
+        m_geoip->addHandler( style, url, selector );
+        const auto alternatives = geoip.value( "alternatives" ).toList();
+        for ( const auto& a : alternatives )
+        {
+            const auto m = a.toMap();
+            m_geoip->addHandler( CalamaresUtils::getString( m, "style" ),
+                                 CalamaresUtils::getString( m, "url" ),
+                                 CalamaresUtils::getString( m, "selector" ) );
+        }
+        m_geoip->setTimeout( std::chrono::seconds( CalamaresUtils::getInteger( geoip, "timeout", 10 ) ) );
+        if ( CalamaresUtils::getBool( geoip, "cache", true ) )
+        {
+            m_geoip->setCacheFile( m_geoip->defaultCacheFile() );
+        }
+        m_geoip->setFallbackDatabase( CalamaresUtils::getString( geoip, "fallbackDatabase" ) );
         if ( !m_geoip->isValid() )
         {
             cWarning() << "GeoIP Style" << style << "is not recognized.";
@@ -230,18 +244,10 @@ LocaleViewStep::checkRequirements()
     LocaleGlobal::init();
     if ( m_geoip && m_geoip->isValid() )
     {
-        auto& network = CalamaresUtils::Network::Manager::instance();
-        if ( network.hasInternet() )
-        {
-            fetchGeoIpTimezone();
-        }
-        else
-        {
-            if ( network.synchronousPing( m_geoip->url() ) )
-            {
-                fetchGeoIpTimezone();
-            }
-        }
+        // No need to check connectivity first: the providers are
+        // asked all at once, with a timeout, and there may be a
+        // cached result or a local fallback.
+        fetchGeoIpTimezone();
     }
 
     return Calamares::RequirementsList();
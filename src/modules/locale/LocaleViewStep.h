@@ -20,8 +20,8 @@
 #ifndef LOCALEVIEWSTEP_H
 #define LOCALEVIEWSTEP_H
 
-#include "geoip/Handler.h"
 #include "geoip/Interface.h"
+#include "geoip/MultiHandler.h"
 #include "utils/PluginFactory.h"
 #include "viewpages/ViewStep.h"
 
@@ -79,7 +79,7 @@ private:
     QString m_localeGenPath;
 
     QList< Calamares::job_ptr > m_jobs;
-    std::unique_ptr< CalamaresUtils::GeoIP::Handler > m_geoip;
+    std::unique_ptr< CalamaresUtils::GeoIP::MultiHandler > m_geoip;
 };
 
 CALAMARES_PLUGIN_FACTORY_DECLARATION( LocaleViewStepFactory )
@@ -0,0 +1,53 @@
+#! /usr/bin/env python3
+#
+# === This file is part of Calamares - <https://github.com/calamares> ===
+#
+#   Copyright 2026, agent <agent@local>
+#
+#   Calamares is free software: you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation, either version 3 of the License, or
+#   (at your option) any later version.
+#
+#   Calamares is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with Calamares. If not, see <http://www.gnu.org/licenses/>.
+"""
+Combines the timezone_*.png images into zones.png, an 8-bit
+indexed image that labels each pixel with the zone it belongs to.
+This needs Python Imaging (Pillow). Run it from this directory
+after changing any of the zone images, and commit zones.png.
+
+The zones are numbered in the order of ZONES (which must match
+the ZONES in timezonewidget.h). Zone number k uses palette
+index 2k+1 for land and 2k+2 for sea; index 0 is outside of
+any zone. Where zones overlap, the first zone in ZONES wins.
+"""
+
+from PIL import Image
+
+ZONES = "0.0 1.0 2.0 3.0 3.5 4.0 4.5 5.0 5.5 5.75 6.0 6.5 7.0 8.0 9.0 9.5 10.0 10.5 11.0 11.5 12.0 12.75 13.0 -1.0 -2.0 -3.0 -3.5 -4.0 -4.5 -5.0 -5.5 -6.0 -7.0 -8.0 -9.0 -9.5 -10.0 -11.0".split()
+# Land is drawn opaque in the zone images, sea is translucent
+LAND_ALPHA = 180
+LAND = (140, 206, 85, 255)
+SEA = (62, 115, 197, 109)
+
+labels = None
+for k, zone in enumerate(ZONES):
+    image = Image.open("timezone_{}.png".format(zone)).convert("RGBA")
+    if labels is None:
+        width, height = image.size
+        labels = bytearray(width * height)
+    assert image.size == (width, height)
+    alpha = image.getchannel("A").tobytes()
+    for i, a in enumerate(alpha):
+        if a and not labels[i]:
+            labels[i] = 2 * k + (1 if a >= LAND_ALPHA else 2)
+
+out = Image.frombytes("P", (width, height), bytes(labels))
+out.putpalette([0, 0, 0] + list(LAND[:3] + SEA[:3]) * len(ZONES))
+out.save("zones.png", optimize=True, transparency=bytes([0] + [LAND[3], SEA[3]] * len(ZONES)))
@@ -57,7 +57,8 @@ LocaleGlobal::Location::comment() const
 void
 LocaleGlobal::init() {
     // TODO: Error handling
-    initLocales();
+    // The locales are not needed for the locale page, and reading
+    // them means parsing every file in LOCALESDIR, so that waits.
     initLocations();
 }
 
@@ -65,6 +66,8 @@ LocaleGlobal::init() {
 
 QHash< QString, QHash< QString, QList< LocaleGlobal::Locale > > >
 LocaleGlobal::getLocales() {
+    if (locales.isEmpty())
+        initLocales();
     return locales;
 }
 
@@ -143,13 +146,18 @@ LocaleGlobal::initLocations() {
         if (line.isEmpty())
             continue;
 
-        QStringList list = line.split(QRegExp("[\t ]"), QString::SkipEmptyParts);
+        QStringList list = line.simplified().split(' ', QString::SkipEmptyParts);
         if (list.size() < 3)
             continue;
 
         Location location;
         QStringList timezoneParts = list.at(2).split('/', QString::SkipEmptyParts);
-        int cooSplitPos = QString(list.at(1)).remove(0, 1).indexOf(QRegExp("[-+]")) + 1;
+        // Coordinates are +-DDMM+-DDDMM, split at the second sign
+        const QString& coordinates = list.at(1);
+        int cooSplitPos = 1;
+        while (cooSplitPos < coordinates.length()
+               && coordinates.at(cooSplitPos) != '-' && coordinates.at(cooSplitPos) != '+')
+            ++cooSplitPos;
 
         if (timezoneParts.size() < 2)
             continue;
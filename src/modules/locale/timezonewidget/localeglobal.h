@@ -53,6 +53,7 @@ public:
     };
 
     static void init();
+    // The locales are read (from LOCALESDIR) on first use
     static QHash<QString, QHash<QString, QList<LocaleGlobal::Locale> > > getLocales();
     static QHash<QString, QList<LocaleGlobal::Location> > getLocations();
 
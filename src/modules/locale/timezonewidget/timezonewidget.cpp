@@ -21,6 +21,7 @@
  *   along with Calamares. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <climits>
 #include <cmath>
 
 #include "utils/Logger.h"
@@ -31,16 +32,19 @@
 static constexpr double MAP_Y_OFFSET = 0.125;
 static constexpr double MAP_X_OFFSET = -0.0370;
 constexpr static double MATH_PI = 3.14159265;
-
-#ifdef DEBUG_TIMEZONES
-// Adds a label to the timezone with this name
-constexpr static QLatin1String ZONE_NAME( "zone" );
-#endif
+// Size (in pixels) of the grid cells for finding the nearest location
+constexpr static int GRID_CELL = 24;
+// How close (in pixels) the mouse has to be to highlight a location
+constexpr static int HOVER_DISTANCE = 12;
 
 TimeZoneWidget::TimeZoneWidget( QWidget* parent ) :
     QWidget( parent )
 {
+#ifdef DEBUG_TIMEZONES
     setMouseTracking( false );
+#else
+    setMouseTracking( true );
+#endif
     setCursor( Qt::PointingHandCursor );
 
     // Font
@@ -55,14 +59,12 @@ TimeZoneWidget::TimeZoneWidget( QWidget* parent ) :
     setMinimumSize( background.size() );
     setMaximumSize( background.size() );
 
-    // Zone images
-    QStringList zones = QString( ZONES ).split( " ", QString::SkipEmptyParts );
-    for ( int i = 0; i < zones.size(); ++i )
+    // Zone labels; the highlighted zone is drawn from these on demand
+    zoneLabels = QImage( ":/images/zones.png" );
+    if ( zoneLabels.format() != QImage::Format_Indexed8 || zoneLabels.size() != background.size() )
     {
-        timeZoneImages.append( QImage( ":/images/timezone_" + zones.at( i ) + ".png" ).scaled( X_SIZE, Y_SIZE, Qt::IgnoreAspectRatio, Qt::SmoothTransformation ) );
-#ifdef DEBUG_TIMEZONES
-        timeZoneImages.last().setText( ZONE_NAME, zones.at( i ) );
-#endif
+        cWarning() << "Timezone label image is unusable" << zoneLabels.format() << zoneLabels.size();
+        zoneLabels = QImage();
     }
 }
 
@@ -93,39 +95,20 @@ void TimeZoneWidget::setCurrentLocation( LocaleGlobal::Location location )
     // Set zone
     QPoint pos = getLocationPosition( currentLocation.longitude, currentLocation.latitude );
 
+    const int zone = getZone( pos );
+    if ( zone != currentZone )
+    {
+        currentZone = zone;
+        currentZoneImage = getZoneImage( zone );
+    }
+
 #ifdef DEBUG_TIMEZONES
     cDebug() << "Setting location" << location.region << location.zone << location.country;
     cDebug() << Logger::SubEntry << "longitude" << location.longitude << "latitude" << location.latitude;
     cDebug() << Logger::SubEntry << "pixel x" << pos.x() << "pixel y" << pos.y();
-
-    bool found = false;
-#endif
-
-
-    for ( int i = 0; i < timeZoneImages.size(); ++i )
-    {
-        QImage zone = timeZoneImages[i];
-
-        // If not transparent set as current
-        if ( zone.pixel( pos ) != RGB_TRANSPARENT )
-        {
-#ifdef DEBUG_TIMEZONES
-            // Log *all* the zones that contain this point,
-            // but only pick the first.
-            if ( !found )
-            {
-                currentZoneImage = zone;
-                found = true;
-                cDebug() << Logger::SubEntry << "First zone found" << i << zone.text( ZONE_NAME );
-            }
-            else
-                cDebug() << Logger::SubEntry << "Also in zone" << i << zone.text( ZONE_NAME );
-#else
-            currentZoneImage = zone;
-            break;
+    if ( zone >= 0 )
+        cDebug() << Logger::SubEntry << "Zone found" << zone << QString( ZONES ).split( " ", QString::SkipEmptyParts ).value( zone );
 #endif
-        }
-    }
 
     // Repaint widget
     repaint();
@@ -138,6 +121,104 @@ void TimeZoneWidget::setCurrentLocation( LocaleGlobal::Location location )
 //###
 
 
+int TimeZoneWidget::getZone( const QPoint& pos ) const
+{
+    if ( !zoneLabels.valid( pos ) )
+        return -1;
+
+    const int index = zoneLabels.pixelIndex( pos );
+    return index > 0 ? ( index - 1 ) / 2 : -1;
+}
+
+
+QImage TimeZoneWidget::getZoneImage( int zone ) const
+{
+    const int land = 2 * zone + 1;
+    const int sea = 2 * zone + 2;
+    if ( zone < 0 || sea >= zoneLabels.colorCount() )
+        return QImage();
+
+    // Hide everything but this zone, and convert once so that
+    // painting doesn't need to deal with the indexed image.
+    QVector<QRgb> colors( zoneLabels.colorCount(), qRgba( 0, 0, 0, 0 ) );
+    colors[ land ] = zoneLabels.color( land );
+    colors[ sea ] = zoneLabels.color( sea );
+
+    QImage image( zoneLabels );
+    image.setColorTable( colors );
+    return image.convertToFormat( QImage::Format_ARGB32_Premultiplied );
+}
+
+
+void TimeZoneWidget::buildLocationIndex()
+{
+    locationGridSize = size();
+    locationGridColumns = width() / GRID_CELL + 1;
+    locationGridRows = height() / GRID_CELL + 1;
+    locationGrid = QVector<QVector<int> >( locationGridColumns * locationGridRows );
+    projectedLocations.clear();
+    hoverIndex = -1;
+
+    const QHash<QString, QList<LocaleGlobal::Location> > hash = LocaleGlobal::getLocations();
+    for ( auto iter = hash.constBegin(); iter != hash.constEnd(); ++iter )
+    {
+        for ( const LocaleGlobal::Location& loc : iter.value() )
+        {
+            const QPoint pos = getLocationPosition( loc.longitude, loc.latitude );
+            const int cell = ( pos.y() / GRID_CELL ) * locationGridColumns + pos.x() / GRID_CELL;
+            locationGrid[ cell ].append( projectedLocations.count() );
+            projectedLocations.append( ProjectedLocation{ pos, loc } );
+        }
+    }
+}
+
+
+int TimeZoneWidget::findNearestLocation( const QPoint& pos, int maxDistance )
+{
+    if ( locationGridSize != size() )
+        buildLocationIndex();
+
+    const int column = qBound( 0, pos.x() / GRID_CELL, locationGridColumns - 1 );
+    const int row = qBound( 0, pos.y() / GRID_CELL, locationGridRows - 1 );
+    const int maxRing = qMax( locationGridColumns, locationGridRows );
+
+    int nearest = -1;
+    int nearestDistance = maxDistance >= 0 ? maxDistance + 1 : INT_MAX;
+    // Look at the rings of cells around pos; once ring r has been
+    // searched, anything further away is at least r * GRID_CELL away.
+    for ( int ring = 0; ring <= maxRing; ++ring )
+    {
+        for ( int r = row - ring; r <= row + ring; ++r )
+        {
+            if ( r < 0 || r >= locationGridRows )
+                continue;
+            for ( int c = column - ring; c <= column + ring; ++c )
+            {
+                if ( c < 0 || c >= locationGridColumns )
+                    continue;
+                // Only the border of the ring, the inside is done already
+                if ( qAbs( r - row ) != ring && qAbs( c - column ) != ring )
+                    continue;
+
+                for ( int i : locationGrid.at( r * locationGridColumns + c ) )
+                {
+                    const QPoint d = projectedLocations.at( i ).position - pos;
+                    const int distance = d.manhattanLength();
+                    if ( distance < nearestDistance )
+                    {
+                        nearest = i;
+                        nearestDistance = distance;
+                    }
+                }
+            }
+        }
+        if ( nearestDistance <= ring * GRID_CELL )
+            break;
+    }
+    return nearest;
+}
+
+
 QPoint TimeZoneWidget::getLocationPosition( double longitude, double latitude )
 {
     const int width = this->width();
@@ -184,11 +265,36 @@ QPoint TimeZoneWidget::getLocationPosition( double longitude, double latitude )
 }
 
 
-void TimeZoneWidget::paintEvent( QPaintEvent* )
+void TimeZoneWidget::drawLabel( QPainter& painter, const QPoint& point, const QString& text, const QColor& color )
 {
     const int width = this->width();
     const int height = this->height();
     QFontMetrics fontMetrics( font );
+
+    const int textWidth = fontMetrics.width( text );
+    const int textHeight = fontMetrics.height();
+
+    QRect rect = QRect( point.x() - textWidth/2 - 5, point.y() - textHeight - 8, textWidth + 10, textHeight - 2 );
+
+    if ( rect.x() <= 5 )
+        rect.moveLeft( 5 );
+    if ( rect.right() >= width-5 )
+        rect.moveRight( width - 5 );
+    if ( rect.y() <= 5 )
+        rect.moveTop( 5 );
+    if ( rect.y() >= height-5 )
+        rect.moveBottom( height-5 );
+
+    painter.setPen( QPen() ); // no pen
+    painter.setBrush( color );
+    painter.drawRoundedRect( rect, 3, 3 );
+    painter.setPen( Qt::white );
+    painter.drawText( rect.x() + 5, rect.bottom() - 4, text );
+}
+
+
+void TimeZoneWidget::paintEvent( QPaintEvent* )
+{
     QPainter painter( this );
 
     painter.setRenderHint( QPainter::Antialiasing );
@@ -201,6 +307,7 @@ void TimeZoneWidget::paintEvent( QPaintEvent* )
     painter.drawImage( 0, 0, currentZoneImage );
 
 #ifdef DEBUG_TIMEZONES
+    const int width = this->width();
     QPoint point = getLocationPosition( currentLocation.longitude, currentLocation.latitude );
     // Draw latitude lines
     for ( int y_lat = -50; y_lat < 80 ; y_lat+=5 )
@@ -225,25 +332,20 @@ void TimeZoneWidget::paintEvent( QPaintEvent* )
     painter.drawImage( point.x() - pin.width()/2, point.y() - pin.height()/2, pin );
 
     // Draw text and box
-    const int textWidth = fontMetrics.width( LocaleGlobal::Location::pretty( currentLocation.zone ) );
-    const int textHeight = fontMetrics.height();
-
-    QRect rect = QRect( point.x() - textWidth/2 - 5, point.y() - textHeight - 8, textWidth + 10, textHeight - 2 );
-
-    if ( rect.x() <= 5 )
-        rect.moveLeft( 5 );
-    if ( rect.right() >= width-5 )
-        rect.moveRight( width - 5 );
-    if ( rect.y() <= 5 )
-        rect.moveTop( 5 );
-    if ( rect.y() >= height-5 )
-        rect.moveBottom( height-5 );
+    drawLabel( painter, point, LocaleGlobal::Location::pretty( currentLocation.zone ), QColor( 40, 40, 40 ) );
 
-    painter.setPen( QPen() ); // no pen
-    painter.setBrush( QColor( 40, 40, 40 ) );
-    painter.drawRoundedRect( rect, 3, 3 );
-    painter.setPen( Qt::white );
-    painter.drawText( rect.x() + 5, rect.bottom() - 4, LocaleGlobal::Location::pretty( currentLocation.zone ) );
+    // Highlight the location under the mouse, unless it is already selected
+    if ( hoverIndex >= 0 && hoverIndex < projectedLocations.count() )
+    {
+        const ProjectedLocation& hover = projectedLocations.at( hoverIndex );
+        if ( hover.location.zone != currentLocation.zone || hover.location.region != currentLocation.region )
+        {
+            painter.setPen( Qt::white );
+            painter.setBrush( QColor( 40, 40, 40 ) );
+            painter.drawEllipse( hover.position, 3, 3 );
+            drawLabel( painter, hover.position, LocaleGlobal::Location::pretty( hover.location.zone ), QColor( 40, 40, 40, 160 ) );
+        }
+    }
 #endif
 
     painter.end();
@@ -257,34 +359,35 @@ void TimeZoneWidget::mousePressEvent( QMouseEvent* event )
         return;
 
     // Set nearest location
-    int nX = 999999, mX = event->pos().x();
-    int nY = 999999, mY = event->pos().y();
-    QHash<QString, QList<LocaleGlobal::Location> > hash = LocaleGlobal::getLocations();
-    QHash<QString, QList<LocaleGlobal::Location> >::iterator iter = hash.begin();
+    const int nearest = findNearestLocation( event->pos() );
+    if ( nearest < 0 )
+        return;
+    currentLocation = projectedLocations.at( nearest ).location;
 
-    while ( iter != hash.end() )
-    {
-        QList<LocaleGlobal::Location> locations = iter.value();
+    // Set zone image and repaint widget
+    setCurrentLocation( currentLocation );
 
-        for ( int i = 0; i < locations.size(); ++i )
-        {
-            LocaleGlobal::Location loc = locations[i];
-            QPoint locPos = getLocationPosition( loc.longitude, loc.latitude );
+    // Emit signal
+    emit locationChanged( currentLocation );
+}
 
-            if ( ( abs( mX - locPos.x() ) + abs( mY - locPos.y() )  <  abs( mX - nX ) + abs( mY - nY ) ) )
-            {
-                currentLocation = loc;
-                nX = locPos.x();
-                nY = locPos.y();
-            }
-        }
 
-        ++iter;
+void TimeZoneWidget::mouseMoveEvent( QMouseEvent* event )
+{
+    const int nearest = findNearestLocation( event->pos(), HOVER_DISTANCE );
+    if ( nearest != hoverIndex )
+    {
+        hoverIndex = nearest;
+        update();
     }
+}
 
-    // Set zone image and repaint widget
-    setCurrentLocation( currentLocation );
 
-    // Emit signal
-    emit locationChanged( currentLocation );
+void TimeZoneWidget::leaveEvent( QEvent* )
+{
+    if ( hoverIndex >= 0 )
+    {
+        hoverIndex = -1;
+        update();
+    }
 }
@@ -34,10 +34,11 @@
 #include <QMouseEvent>
 #include <QFontMetrics>
 #include <QFont>
+#include <QVector>
 #include "localeglobal.h"
 
 
-#define RGB_TRANSPARENT 0
+// The zones, in the order they are labeled in zones.png (see make-zones.py)
 #define ZONES "0.0 1.0 2.0 3.0 3.5 4.0 4.5 5.0 5.5 5.75 6.0 6.5 7.0 8.0 9.0 9.5 10.0 10.5 11.0 11.5 12.0 12.75 13.0 -1.0 -2.0 -3.0 -3.5 -4.0 -4.5 -5.0 -5.5 -6.0 -7.0 -8.0 -9.0 -9.5 -10.0 -11.0"
 #define X_SIZE 780
 #define Y_SIZE 340
@@ -62,17 +63,47 @@ signals:
 private:
     QFont font;
     QImage background, pin, currentZoneImage;
-    QList<QImage> timeZoneImages;
+
+    // Locations projected onto the map, with a grid of buckets
+    // of indexes into projectedLocations for finding the nearest.
+    struct ProjectedLocation
+    {
+        QPoint position;
+        LocaleGlobal::Location location;
+    };
+    QVector<ProjectedLocation> projectedLocations;
+    QVector<QVector<int> > locationGrid;
+    QSize locationGridSize;  // Widget size the grid was built for
+    int locationGridColumns = 0, locationGridRows = 0;
+    int hoverIndex = -1;  // Index into projectedLocations, or -1
+
+    void buildLocationIndex();
+    // Index of the location nearest to @p pos (Manhattan distance,
+    // no further than @p maxDistance if that is non-negative) or -1
+    int findNearestLocation( const QPoint& pos, int maxDistance = -1 );
+
+    QImage zoneLabels;  // Indexed: 0 is no zone, 2k+1 and 2k+2 are zone k
+    int currentZone = -1;
     LocaleGlobal::Location currentLocation;
 
+    // Index of the zone at @p pos, or -1 if there is none
+    int getZone( const QPoint& pos ) const;
+    // Image with only the given zone visible
+    QImage getZoneImage( int zone ) const;
+
     QPoint getLocationPosition( const LocaleGlobal::Location& l )
     {
         return getLocationPosition( l.longitude, l.latitude );
     }
     QPoint getLocationPosition( double longitude, double latitude );
 
+    // Draws @p text in a box of @p color above @p point
+    void drawLabel( QPainter& painter, const QPoint& point, const QString& text, const QColor& color );
+
     void paintEvent( QPaintEvent* event );
     void mousePressEvent( QMouseEvent* event );
+    void mouseMoveEvent( QMouseEvent* event );
+    void leaveEvent( QEvent* event );
 };
 
 #endif // TIMEZONEWIDGET_H
@@ -0,0 +1,123 @@
+/* === This file is part of Calamares - <https://github.com/calamares> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Calamares is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Calamares is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Calamares. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "GroupsCache.h"
+
+#include "utils/Logger.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+
+static QString
+metaPath( const QString& path )
+{
+    return path + QStringLiteral( ".meta" );
+}
+
+GroupsCache::GroupsCache( const QString& path )
+    : m_path( path )
+{
+}
+
+QByteArray
+GroupsCache::checksum( const QByteArray& data )
+{
+    return QCryptographicHash::hash( data, QCryptographicHash::Sha256 ).toHex();
+}
+
+bool
+GroupsCache::load()
+{
+    m_data.clear();
+    m_checksum.clear();
+    m_url.clear();
+    m_etag.clear();
+    m_lastModified.clear();
+
+    QFile dataFile( m_path );
+    if ( !isValid() || !dataFile.open( QIODevice::ReadOnly ) )
+    {
+        return false;
+    }
+    const QByteArray data = dataFile.readAll();
+    const QByteArray sum = checksum( data );
+
+    QFile meta( metaPath( m_path ) );
+    if ( meta.open( QIODevice::ReadOnly ) )
+    {
+        const QJsonObject o = QJsonDocument::fromJson( meta.readAll() ).object();
+        if ( o.value( "sha256" ).toString().toLatin1() != sum )
+        {
+            cWarning() << "netinstall cache" << m_path << "does not match its checksum.";
+            return false;
+        }
+        m_url = QUrl( o.value( "url" ).toString() );
+        m_etag = o.value( "etag" ).toString().toLatin1();
+        m_lastModified = o.value( "last-modified" ).toString().toLatin1();
+    }
+
+    m_data = data;
+    m_checksum = sum;
+    return true;
+}
+
+bool
+GroupsCache::save( const QByteArray& data, const QUrl& url, const QByteArray& etag, const QByteArray& lastModified )
+{
+    if ( !isValid() )
+    {
+        return false;
+    }
+    QDir().mkpath( QFileInfo( m_path ).absolutePath() );
+
+    const QByteArray sum = checksum( data );
+    QJsonObject o;
+    o.insert( "url", url.toString() );
+    o.insert( "sha256", QString::fromLatin1( sum ) );
+    o.insert( "etag", QString::fromLatin1( etag ) );
+    o.insert( "last-modified", QString::fromLatin1( lastModified ) );
+
+    // Write the data first, then the meta file: an interrupted
+    // save leaves a checksum mismatch, which is not used.
+    QSaveFile dataFile( m_path );
+    QSaveFile meta( metaPath( m_path ) );
+    if ( !dataFile.open( QIODevice::WriteOnly ) || dataFile.write( data ) != data.size() || !dataFile.commit() )
+    {
+        cWarning() << "netinstall cache" << m_path << "can not be written.";
+        return false;
+    }
+    if ( !meta.open( QIODevice::WriteOnly ) || meta.write( QJsonDocument( o ).toJson() ) < 0 || !meta.commit() )
+    {
+        cWarning() << "netinstall cache" << metaPath( m_path ) << "can not be written.";
+        QFile::remove( m_path );
+        return false;
+    }
+
+    m_data = data;
+    m_checksum = sum;
+    m_url = url;
+    m_etag = etag;
+    m_lastModified = lastModified;
+    return true;
+}
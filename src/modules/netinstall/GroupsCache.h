@@ -0,0 +1,79 @@
+/* === This file is part of Calamares - <https://github.com/calamares> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Calamares is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Calamares is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Calamares. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef NETINSTALL_GROUPSCACHE_H
+#define NETINSTALL_GROUPSCACHE_H
+
+#include <QByteArray>
+#include <QString>
+#include <QUrl>
+
+/** @brief A local copy of the netinstall groups data
+ *
+ * The cache is a file with the groups data (exactly as it was fetched)
+ * and a *meta* file next to it (the same name, with `.meta` added) that
+ * records where the data came from, the headers needed for a conditional
+ * request, and the SHA-256 checksum of the data.
+ *
+ * A cache file without a meta file is accepted as-is: that is how
+ * a catalogue is shipped on the installation medium. If there is a meta
+ * file, the checksum must match the data, or the cache is not used.
+ */
+class GroupsCache
+{
+public:
+    explicit GroupsCache( const QString& path = QString() );
+
+    /// @brief Is there a path for this cache?
+    bool isValid() const { return !m_path.isEmpty(); }
+    QString path() const { return m_path; }
+
+    /** @brief Reads the cache file (and meta file, if any)
+     *
+     * Returns @c false if there is no cache file, or if
+     * the data does not match the recorded checksum.
+     */
+    bool load();
+    /** @brief Writes @p data and the meta file
+     *
+     * The @p url, @p etag and @p lastModified are used to make a
+     * conditional request next time. Returns @c false if the files
+     * cannot be written (e.g. the cache is on read-only media).
+     */
+    bool save( const QByteArray& data, const QUrl& url, const QByteArray& etag, const QByteArray& lastModified );
+
+    QByteArray data() const { return m_data; }
+    QByteArray checksum() const { return m_checksum; }
+    QUrl url() const { return m_url; }
+    QByteArray etag() const { return m_etag; }
+    QByteArray lastModified() const { return m_lastModified; }
+
+    /// @brief SHA-256 checksum of @p data, in lower-case hex
+    static QByteArray checksum( const QByteArray& data );
+
+private:
+    QString m_path;
+    QByteArray m_data;
+    QByteArray m_checksum;
+    QUrl m_url;
+    QByteArray m_etag;
+    QByteArray m_lastModified;
+};
+
+#endif  // NETINSTALL_GROUPSCACHE_H
@@ -34,39 +34,72 @@
 #include <QHeaderView>
 #include <QNetworkReply>
 
-using CalamaresUtils::yamlToVariant;
-
 NetInstallPage::NetInstallPage( QWidget* parent )
     : QWidget( parent )
     , ui( new Ui::Page_NetInst )
     , m_reply( nullptr )
     , m_groups( nullptr )
+    , m_required( false )
+    , m_activated( false )
 {
     ui->setupUi( this );
+    CALAMARES_RETRANSLATE( if ( m_groups ) {
+        m_groups->setHeaderData( 0, Qt::Horizontal, tr( "Name" ) );
+        m_groups->setHeaderData( 1, Qt::Horizontal, tr( "Description" ) );
+    } )
 }
 
 bool
 NetInstallPage::readGroups( const QByteArray& yamlData )
 {
+    auto* groups = new PackageModel( this );
     try
     {
-        YAML::Node groups = YAML::Load( yamlData.constData() );
-
-        if ( !groups.IsSequence() )
+        if ( !groups->setupModelData( yamlData ) )
         {
-            cWarning() << "netinstall groups data does not form a sequence.";
+            delete groups;
+            return false;
         }
-        Q_ASSERT( groups.IsSequence() );
-        m_groups = new PackageModel( groups );
-        CALAMARES_RETRANSLATE( m_groups->setHeaderData( 0, Qt::Horizontal, tr( "Name" ) );
-                               m_groups->setHeaderData( 1, Qt::Horizontal, tr( "Description" ) ); )
-        return true;
     }
     catch ( YAML::Exception& e )
     {
+        delete groups;
         CalamaresUtils::explainYamlException( e, yamlData, "netinstall groups data" );
         return false;
     }
+
+    // The view may still be showing the previous model (the cached groups),
+    // so delete it only once control returns to the event loop.
+    if ( m_groups )
+    {
+        m_groups->deleteLater();
+    }
+    m_groups = groups;
+    m_groups->setHeaderData( 0, Qt::Horizontal, tr( "Name" ) );
+    m_groups->setHeaderData( 1, Qt::Horizontal, tr( "Description" ) );
+    return true;
+}
+
+void
+NetInstallPage::showGroups()
+{
+    ui->groupswidget->setModel( m_groups );
+    ui->groupswidget->header()->setSectionResizeMode( 0, QHeaderView::ResizeToContents );
+    ui->groupswidget->header()->setSectionResizeMode( 1, QHeaderView::Stretch );
+}
+
+void
+NetInstallPage::fetchFailed( const QString& message )
+{
+    if ( m_groups )
+    {
+        cDebug() << Logger::SubEntry << "Keeping the cached groups from" << m_cache.path();
+        return;
+    }
+    // If m_required is *false* then we still say we're ready
+    // even if the reply is corrupt or missing.
+    ui->netinst_status->setText( message );
+    emit checkReady( !m_required );
 }
 
 /// @brief Convenience to zero out and deleteLater on the reply, used in dataIsHere
@@ -97,37 +130,92 @@ NetInstallPage::dataIsHere()
 
     ReplyDeleter d { m_reply };
 
-    // If m_required is *false* then we still say we're ready
-    // even if the reply is corrupt or missing.
     if ( m_reply->error() != QNetworkReply::NoError )
     {
         cWarning() << "unable to fetch netinstall package lists.";
         cDebug() << Logger::SubEntry << "Netinstall reply error: " << m_reply->error();
         cDebug() << Logger::SubEntry << "Request for url: " << m_reply->url().toString()
                  << " failed with: " << m_reply->errorString();
-        ui->netinst_status->setText(
+        fetchFailed(
             tr( "Network Installation. (Disabled: Unable to fetch package lists, check your network connection)" ) );
-        emit checkReady( !m_required );
         return;
     }
 
-    if ( !readGroups( m_reply->readAll() ) )
+    // A conditional request is only made while the cached groups are shown
+    if ( m_reply->attribute( QNetworkRequest::HttpStatusCodeAttribute ).toInt() == 304 )
+    {
+        cDebug() << Logger::SubEntry << "Cached groups are up-to-date.";
+        return;
+    }
+
+    const QByteArray data = m_reply->readAll();
+    const QByteArray sum = GroupsCache::checksum( data );
+    if ( !m_expectedChecksum.isEmpty() && sum != m_expectedChecksum )
+    {
+        cWarning() << "netinstall groups data does not match the published checksum.";
+        cDebug() << Logger::SubEntry << "Expected:" << m_expectedChecksum << "got:" << sum;
+        fetchFailed( tr( "Network Installation. (Disabled: Received invalid groups data)" ) );
+        return;
+    }
+
+    const QByteArray etag = m_reply->rawHeader( "ETag" );
+    const QByteArray lastModified = m_reply->rawHeader( "Last-Modified" );
+    if ( m_groups && ( sum == m_cache.checksum() ) )
+    {
+        cDebug() << Logger::SubEntry << "Cached groups are unchanged.";
+        m_cache.save( data, m_reply->url(), etag, lastModified );
+        return;
+    }
+    if ( m_groups && m_activated )
+    {
+        // Don't pull the groups out from under the user; the new
+        // data is used the next time Calamares starts.
+        cDebug() << Logger::SubEntry << "Groups changed while shown, updating the cache only.";
+        m_cache.save( data, m_reply->url(), etag, lastModified );
+        return;
+    }
+
+    if ( !readGroups( data ) )
     {
         cWarning() << "netinstall groups data was received, but invalid.";
         cDebug() << Logger::SubEntry << "Url:     " << m_reply->url().toString();
         cDebug() << Logger::SubEntry << "Headers: " << m_reply->rawHeaderList();
-        ui->netinst_status->setText( tr( "Network Installation. (Disabled: Received invalid groups data)" ) );
-        emit checkReady( !m_required );
+        fetchFailed( tr( "Network Installation. (Disabled: Received invalid groups data)" ) );
         return;
     }
 
-    ui->groupswidget->setModel( m_groups );
-    ui->groupswidget->header()->setSectionResizeMode( 0, QHeaderView::ResizeToContents );
-    ui->groupswidget->header()->setSectionResizeMode( 1, QHeaderView::Stretch );
-
+    showGroups();
+    m_cache.save( data, m_reply->url(), etag, lastModified );
     emit checkReady( true );
 }
 
+void
+NetInstallPage::checksumIsHere()
+{
+    if ( !m_reply || !m_reply->isFinished() )
+    {
+        cWarning() << "NetInstall checksum called too early.";
+        return;
+    }
+
+    {
+        ReplyDeleter d { m_reply };
+
+        // sha256sum format: checksum, whitespace, filename
+        const QByteArray sum = m_reply->readAll().simplified().split( ' ' ).first().toLower();
+        if ( m_reply->error() != QNetworkReply::NoError || sum.length() != 64 )
+        {
+            cWarning() << "unable to fetch netinstall groups checksum from" << m_reply->url().toString();
+            fetchFailed(
+                tr( "Network Installation. (Disabled: Unable to fetch package lists, check your network connection)" ) );
+            return;
+        }
+        m_expectedChecksum = sum;
+    }
+    // After the deleter is done with the checksum reply
+    fetchGroups();
+}
+
 PackageModel::PackageItemDataList
 NetInstallPage::selectedPackages() const
 {
@@ -147,15 +235,62 @@ NetInstallPage::loadGroupList( const QString& confUrl )
 {
     using namespace CalamaresUtils::Network;
 
-    cDebug() << "NetInstall loading groups from" << confUrl;
-    QNetworkReply* reply = Manager::instance().asynchronouseGet(
-        QUrl( confUrl ),
-        RequestOptions( RequestOptions::FakeUserAgent | RequestOptions::FollowRedirect, std::chrono::seconds( 30 ) ) );
+    m_groupsUrl = QUrl( confUrl );
+    if ( m_cache.isValid() && m_cache.load() && readGroups( m_cache.data() ) )
+    {
+        cDebug() << "NetInstall using cached groups from" << m_cache.path();
+        showGroups();
+        emit checkReady( true );
+    }
+
+    if ( m_checksumUrl.isValid() )
+    {
+        cDebug() << "NetInstall loading checksum from" << m_checksumUrl;
+        QNetworkReply* reply = Manager::instance().asynchronouseGet(
+            m_checksumUrl,
+            RequestOptions( RequestOptions::FakeUserAgent | RequestOptions::FollowRedirect,
+                            std::chrono::seconds( 30 ) ) );
+        if ( reply )
+        {
+            m_reply = reply;
+            connect( reply, &QNetworkReply::finished, this, &NetInstallPage::checksumIsHere );
+            return;
+        }
+        cDebug() << Logger::Continuation << "checksum request failed immediately.";
+    }
+    fetchGroups();
+}
 
+void
+NetInstallPage::fetchGroups()
+{
+    using namespace CalamaresUtils::Network;
+
+    cDebug() << "NetInstall loading groups from" << m_groupsUrl;
+    RequestOptions options( RequestOptions::FakeUserAgent | RequestOptions::FollowRedirect,
+                            std::chrono::seconds( 30 ) );
+    // Only ask for changes if the cached groups came from the same place
+    // and are actually shown (a 304 reply has no data to fall back on).
+    if ( m_groups && m_cache.url() == m_groupsUrl )
+    {
+        if ( !m_cache.etag().isEmpty() )
+        {
+            options.addHeader( "If-None-Match", m_cache.etag() );
+        }
+        if ( !m_cache.lastModified().isEmpty() )
+        {
+            options.addHeader( "If-Modified-Since", m_cache.lastModified() );
+        }
+    }
+
+    QNetworkReply* reply = Manager::instance().asynchronouseGet( m_groupsUrl, options );
     if ( !reply )
     {
         cDebug() << Logger::Continuation << "request failed immediately.";
-        ui->netinst_status->setText( tr( "Network Installation. (Disabled: Incorrect configuration)" ) );
+        if ( !m_groups )
+        {
+            ui->netinst_status->setText( tr( "Network Installation. (Disabled: Incorrect configuration)" ) );
+        }
     }
     else
     {
@@ -164,6 +299,18 @@ NetInstallPage::loadGroupList( const QString& confUrl )
     }
 }
 
+void
+NetInstallPage::setCacheFile( const QString& path )
+{
+    m_cache = GroupsCache( path );
+}
+
+void
+NetInstallPage::setChecksumUrl( const QString& url )
+{
+    m_checksumUrl = url.isEmpty() ? QUrl() : QUrl( url );
+}
+
 void
 NetInstallPage::setRequired( bool b )
 {
@@ -174,5 +321,6 @@ NetInstallPage::setRequired( bool b )
 void
 NetInstallPage::onActivate()
 {
+    m_activated = true;
     ui->groupswidget->setFocus();
 }
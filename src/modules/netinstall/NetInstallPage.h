@@ -21,10 +21,12 @@
 #ifndef NETINSTALLPAGE_H
 #define NETINSTALLPAGE_H
 
+#include "GroupsCache.h"
 #include "PackageModel.h"
-#include "PackageTreeItem.h"
+#include "PackageTree.h"
 
 #include <QString>
+#include <QUrl>
 #include <QWidget>
 
 class QNetworkReply;
@@ -45,10 +47,26 @@ public:
     /** @brief Retrieves the groups, with name, description and packages
      *
      * Loads data from the given URL. This should be called before
-     * displaying the page.
+     * displaying the page. If there is a cache (see setCacheFile()),
+     * the cached groups are shown immediately and the URL is
+     * used to refresh the cache in the background.
      */
     void loadGroupList( const QString& url );
 
+    /** @brief Use @p path as local copy of the groups data
+     *
+     * Call this before loadGroupList(). The file may be shipped on
+     * the installation medium; it is updated when fresh data is fetched.
+     */
+    void setCacheFile( const QString& path );
+    /** @brief Check fetched groups data against a published checksum
+     *
+     * The @p url points to a file in `sha256sum` format; only the first
+     * word is used. Fetched data that does not match is not used.
+     * Call this before loadGroupList().
+     */
+    void setChecksumUrl( const QString& url );
+
     // Sets the "required" state of netinstall data. Influences whether
     // corrupt or unavailable data causes checkReady() to be emitted
     // true (not-required) or false.
@@ -62,6 +80,7 @@ public:
 
 public slots:
     void dataIsHere();
+    void checksumIsHere();
 
 signals:
     void checkReady( bool );
@@ -71,12 +90,24 @@ private:
     // m_groups and m_groupOrder internal structures. See the README.md
     // of this module to know the format expected of the YAML files.
     bool readGroups( const QByteArray& yamlData );
+    // Puts m_groups into the tree view.
+    void showGroups();
+    // Starts the (conditional) request for the groups data.
+    void fetchGroups();
+    // Reports a failure to fetch; if there are cached groups, they remain.
+    void fetchFailed( const QString& message );
 
     Ui::Page_NetInst* ui;
 
     QNetworkReply* m_reply;
     PackageModel* m_groups;
     bool m_required;
+    bool m_activated;  // Has the page been shown? Then don't replace the groups.
+
+    GroupsCache m_cache;
+    QUrl m_groupsUrl;
+    QUrl m_checksumUrl;
+    QByteArray m_expectedChecksum;
 };
 
 #endif  // NETINSTALLPAGE_H
@@ -177,6 +177,8 @@ NetInstallViewStep::setConfigurationMap( const QVariantMap& configurationMap )
         // Keep putting groupsUrl into the global storage,
         // even though it's no longer used for in-module data-passing.
         Calamares::JobQueue::instance()->globalStorage()->insert( "groupsUrl", groupsUrl );
+        m_widget->setCacheFile( CalamaresUtils::getString( configurationMap, "groupsCache" ) );
+        m_widget->setChecksumUrl( CalamaresUtils::getString( configurationMap, "groupsChecksumUrl" ) );
         m_widget->loadGroupList( groupsUrl );
     }
 }
@@ -19,19 +19,32 @@
 
 #include "PackageModel.h"
 
-#include "utils/Yaml.h"
+#include "utils/Logger.h"
 
-PackageModel::PackageModel( const YAML::Node& data, QObject* parent ) :
+PackageModel::PackageModel( QObject* parent ) :
     QAbstractItemModel( parent ),
+    m_fetched( 1, true ),
     m_columnHeadings()
 {
-    m_rootItem = new PackageTreeItem();
-    setupModelData( data, m_rootItem );
 }
 
 PackageModel::~PackageModel()
 {
-    delete m_rootItem;
+}
+
+bool
+PackageModel::setupModelData( const QByteArray& yamlData )
+{
+    PackageTree tree;
+    if ( !tree.load( yamlData, []( const QByteArray& s ) { return tr( s.constData() ); } ) )
+        return false;
+
+    beginResetModel();
+    m_tree = tree;
+    m_fetched = QVector< bool >( m_tree.count(), false );
+    m_fetched[ PackageTree::RootIndex ] = true;
+    endResetModel();
+    return true;
 }
 
 QModelIndex
@@ -40,18 +53,8 @@ PackageModel::index( int row, int column, const QModelIndex& parent ) const
     if ( !hasIndex( row, column, parent ) )
         return QModelIndex();
 
-    PackageTreeItem* parentItem;
-
-    if ( !parent.isValid() )
-        parentItem = m_rootItem;
-    else
-        parentItem = static_cast<PackageTreeItem*>( parent.internalPointer() );
-
-    PackageTreeItem* childItem = parentItem->child( row );
-    if ( childItem )
-        return createIndex( row, column, childItem );
-    else
-        return QModelIndex();
+    const PackageTree::Index child = m_tree.child( treeIndex( parent ), row );
+    return createIndex( row, column, quintptr( child ) );
 }
 
 QModelIndex
@@ -60,12 +63,10 @@ PackageModel::parent( const QModelIndex& index ) const
     if ( !index.isValid() )
         return QModelIndex();
 
-    PackageTreeItem* child = static_cast<PackageTreeItem*>( index.internalPointer() );
-    PackageTreeItem* parent = child->parentItem();
-
-    if ( parent == m_rootItem )
+    const PackageTree::Index parent = m_tree.node( treeIndex( index ) ).parent;
+    if ( parent == PackageTree::RootIndex )
         return QModelIndex();
-    return createIndex( parent->row(), 0, parent );
+    return createIndex( m_tree.node( parent ).row, 0, quintptr( parent ) );
 }
 
 int
@@ -74,21 +75,44 @@ PackageModel::rowCount( const QModelIndex& parent ) const
     if ( parent.column() > 0 )
         return 0;
 
-    PackageTreeItem* parentItem;
-    if ( !parent.isValid() )
-        parentItem = m_rootItem;
-    else
-        parentItem = static_cast<PackageTreeItem*>( parent.internalPointer() );
-
-    return parentItem->childCount();
+    const PackageTree::Index p = treeIndex( parent );
+    return m_fetched.at( p ) ? m_tree.node( p ).childCount : 0;
 }
 
 int
 PackageModel::columnCount( const QModelIndex& parent ) const
 {
-    if ( parent.isValid() )
-        return static_cast<PackageTreeItem*>( parent.internalPointer() )->columnCount();
-    return m_rootItem->columnCount();
+    Q_UNUSED( parent )
+    return 2;  // Name, description
+}
+
+bool
+PackageModel::hasChildren( const QModelIndex& parent ) const
+{
+    if ( parent.column() > 0 )
+        return false;
+    return m_tree.node( treeIndex( parent ) ).childCount > 0;
+}
+
+bool
+PackageModel::canFetchMore( const QModelIndex& parent ) const
+{
+    if ( parent.column() > 0 )
+        return false;
+    const PackageTree::Index p = treeIndex( parent );
+    return !m_fetched.at( p ) && m_tree.node( p ).childCount > 0;
+}
+
+void
+PackageModel::fetchMore( const QModelIndex& parent )
+{
+    if ( !canFetchMore( parent ) )
+        return;
+
+    const PackageTree::Index p = treeIndex( parent );
+    beginInsertRows( parent, 0, m_tree.node( p ).childCount - 1 );
+    m_fetched[ p ] = true;
+    endInsertRows();
 }
 
 QVariant
@@ -97,15 +121,27 @@ PackageModel::data( const QModelIndex& index, int role ) const
     if ( !index.isValid() )
         return QVariant();
 
-    PackageTreeItem* item = static_cast<PackageTreeItem*>( index.internalPointer() );
+    const PackageTree::Index item = treeIndex( index );
     if ( index.column() == 0 && role == Qt::CheckStateRole )
-        return item->isSelected();
+        return m_tree.selected( item );
 
-    if ( item->isHidden() && role == Qt::DisplayRole ) // Hidden group
+    if ( m_tree.isHidden( item ) && role == Qt::DisplayRole ) // Hidden group
         return QVariant();
 
     if ( role == Qt::DisplayRole )
-        return item->data( index.column() );
+    {
+        if ( m_tree.isPackage( item ) )
+            return index.column() == 0 ? QVariant( m_tree.name( item ) ) : QVariant();
+        switch ( index.column() )
+        {
+        case 0:
+            return m_tree.name( item );
+        case 1:
+            return m_tree.description( item );
+        default:
+            return QVariant();
+        }
+    }
     return QVariant();
 }
 
@@ -114,11 +150,20 @@ PackageModel::setData( const QModelIndex& index, const QVariant& value, int role
 {
     if ( role == Qt::CheckStateRole && index.isValid() )
     {
-        PackageTreeItem* item = static_cast<PackageTreeItem*>( index.internalPointer() );
-        item->setSelected( static_cast<Qt::CheckState>( value.toInt() ) );
-
-        emit dataChanged( this->index( 0, 0 ), index.sibling( index.column(), index.row() + 1 ),
-                          QVector<int>( Qt::CheckStateRole ) );
+        const PackageTree::Index top
+            = m_tree.setSelected( treeIndex( index ), static_cast<Qt::CheckState>( value.toInt() ) );
+        if ( top == PackageTree::InvalidIndex )
+            return true;
+
+        // One signal for everything that changed: the top-most changed
+        // node, its siblings and all of their descendants. The range
+        // always spans both columns, since views treat a single index
+        // as a single-cell update rather than a (larger) region.
+        const QModelIndex topParent = parent( createIndex( m_tree.node( top ).row, 0, quintptr( top ) ) );
+        const int rows = rowCount( topParent );
+        if ( rows > 0 )
+            emit dataChanged( this->index( 0, 0, topParent ), this->index( rows - 1, 1, topParent ),
+                              QVector<int> { Qt::CheckStateRole } );
     }
     return true;
 }
@@ -158,98 +203,8 @@ PackageModel::headerData( int section, Qt::Orientation orientation, int role ) c
     return QVariant();
 }
 
-QList<PackageTreeItem::ItemData>
+PackageModel::PackageItemDataList
 PackageModel::getPackages() const
 {
-    QList<PackageTreeItem*> items = getItemPackages( m_rootItem );
-    for ( auto package : m_hiddenItems )
-        if ( package->hiddenSelected() )
-            items.append( getItemPackages( package ) );
-    QList<PackageTreeItem::ItemData> packages;
-    for ( auto item : items )
-    {
-        PackageTreeItem::ItemData itemData;
-        itemData.preScript = item->parentItem()->preScript(); // Only groups have hooks
-        itemData.packageName = item->packageName(); // this seg faults
-        itemData.postScript = item->parentItem()->postScript(); // Only groups have hooks
-        itemData.isCritical = item->parentItem()->isCritical(); // Only groups are critical
-        packages.append( itemData );
-    }
-    return packages;
-}
-
-QList<PackageTreeItem*>
-PackageModel::getItemPackages( PackageTreeItem* item ) const
-{
-    QList<PackageTreeItem*> selectedPackages;
-    for ( int i = 0; i < item->childCount(); i++ )
-    {
-        if ( item->child( i )->isSelected() == Qt::Unchecked )
-            continue;
-
-        if ( !item->child( i )->childCount() ) // package
-            selectedPackages.append( item->child( i ) );
-        else
-            selectedPackages.append( getItemPackages( item->child( i ) ) );
-    }
-    return selectedPackages;
-
-}
-
-void
-PackageModel::setupModelData( const YAML::Node& data, PackageTreeItem* parent )
-{
-    for ( YAML::const_iterator it = data.begin(); it != data.end(); ++it )
-    {
-        const YAML::Node itemDefinition = *it;
-
-        QString name(
-            tr( CalamaresUtils::yamlToVariant( itemDefinition["name"] ).toByteArray() ) );
-        QString description(
-            tr( CalamaresUtils::yamlToVariant( itemDefinition["description"] ).toByteArray() ) );
-
-        PackageTreeItem::ItemData itemData;
-        itemData.name = name;
-        itemData.description = description;
-
-        if ( itemDefinition["pre-install"] )
-            itemData.preScript =
-                CalamaresUtils::yamlToVariant( itemDefinition["pre-install"] ).toString();
-        if ( itemDefinition["post-install"] )
-            itemData.postScript =
-                CalamaresUtils::yamlToVariant( itemDefinition["post-install"] ).toString();
-        PackageTreeItem* item = new PackageTreeItem( itemData, parent );
-
-        if ( itemDefinition["selected"] )
-            item->setSelected(
-                CalamaresUtils::yamlToVariant( itemDefinition["selected"] ).toBool() ?
-                Qt::Checked : Qt::Unchecked );
-        else
-            item->setSelected( parent->isSelected() ); // Inherit from it's parent
-
-        if ( itemDefinition["hidden"] )
-            item->setHidden(
-                CalamaresUtils::yamlToVariant( itemDefinition["hidden"] ).toBool() );
-
-        if ( itemDefinition["critical"] )
-            item->setCritical(
-                CalamaresUtils::yamlToVariant( itemDefinition["critical"] ).toBool() );
-
-        if ( itemDefinition["packages"] )
-            for ( YAML::const_iterator packageIt = itemDefinition["packages"].begin();
-                    packageIt != itemDefinition["packages"].end(); ++packageIt )
-                item->appendChild(
-                    new PackageTreeItem( CalamaresUtils::yamlToVariant( *packageIt ).toString(), item ) );
-
-        if ( itemDefinition["subgroups"] )
-            setupModelData( itemDefinition["subgroups"], item );
-
-        if ( item->isHidden() )
-            m_hiddenItems.append( item );
-        else
-        {
-            item->setCheckable( true );
-            parent->appendChild( item );
-        }
-    }
+    return m_tree.packages();
 }
@@ -21,27 +21,30 @@
 #ifndef PACKAGEMODEL_H
 #define PACKAGEMODEL_H
 
-#include "PackageTreeItem.h"
+#include "PackageTree.h"
 
 #include <QAbstractItemModel>
 #include <QObject>
 #include <QString>
-
-namespace YAML
-{
-    class Node;
-}
+#include <QVector>
 
 class PackageModel : public QAbstractItemModel
 {
     Q_OBJECT
 
 public:
-    using PackageItemDataList = QList< PackageTreeItem::ItemData >;
+    using PackageItemDataList = QList< PackageTree::ItemData >;
 
-    explicit PackageModel( const YAML::Node& data, QObject* parent = nullptr );
+    explicit PackageModel( QObject* parent = nullptr );
     ~PackageModel() override;
 
+    /** @brief Loads the groups data (YAML) into the model
+     *
+     * Returns false if the data is not a list of groups; YAML syntax
+     * errors throw a YAML::Exception. See PackageTree::load().
+     */
+    bool setupModelData( const QByteArray& yamlData );
+
     QVariant data( const QModelIndex& index, int role ) const override;
     bool setData( const QModelIndex& index, const QVariant& value,
                   int role = Qt::EditRole ) override;
@@ -55,14 +58,24 @@ public:
     QModelIndex parent( const QModelIndex& index ) const override;
     int rowCount( const QModelIndex& parent = QModelIndex() ) const override;
     int columnCount( const QModelIndex& parent = QModelIndex() ) const override;
+
+    /* The children of a group are only made known to the view when
+     * the group is expanded, so large subgroups cost nothing until needed.
+     */
+    bool hasChildren( const QModelIndex& parent = QModelIndex() ) const override;
+    bool canFetchMore( const QModelIndex& parent ) const override;
+    void fetchMore( const QModelIndex& parent ) override;
+
     PackageItemDataList getPackages() const;
-    QList<PackageTreeItem*> getItemPackages( PackageTreeItem* item ) const;
 
 private:
-    void setupModelData( const YAML::Node& data, PackageTreeItem* parent );
+    PackageTree::Index treeIndex( const QModelIndex& index ) const
+    {
+        return index.isValid() ? static_cast< PackageTree::Index >( index.internalId() ) : PackageTree::RootIndex;
+    }
 
-    PackageTreeItem* m_rootItem;
-    QList<PackageTreeItem*> m_hiddenItems;
+    PackageTree m_tree;
+    QVector< bool > m_fetched;  ///< Per node, have the children been reported?
     QVariantList m_columnHeadings;
 };
 
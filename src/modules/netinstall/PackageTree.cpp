@@ -0,0 +1,517 @@
+/* === This file is part of Calamares - <https://github.com/calamares> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Calamares is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Calamares is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Calamares. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "PackageTree.h"
+
+#include "utils/Logger.h"
+#include "utils/Yaml.h"
+
+#include <yaml-cpp/eventhandler.h>
+#include <yaml-cpp/mark.h>
+
+#include <QHash>
+#include <QPair>
+
+#include <sstream>
+
+/** @brief A group as it is read from the YAML data
+ *
+ * Groups are collected in a flat list while parsing; group 0
+ * is the (implicit) root, whose subgroups are the top-level groups.
+ */
+struct ParsedGroup
+{
+    int name = 0;
+    int description = 0;
+    int preScript = 0;
+    int postScript = 0;
+    int selected = -1;  ///< -1 means "inherit from the parent"
+    bool critical = false;
+    bool hidden = false;
+    QVector< int > packages;  ///< string indexes
+    QVector< int > subgroups;  ///< indexes of parsed groups
+};
+
+/** @brief Event handler for the YAML parser that collects groups
+ *
+ * This keeps a stack of what kind of YAML structure is being read,
+ * and ignores everything that it does not understand.
+ */
+class GroupsParser : public YAML::EventHandler
+{
+public:
+    GroupsParser( const PackageTree::Translator& translate )
+        : m_translate( translate )
+        , m_valid( false )
+        , m_haveKey( false )
+    {
+        m_strings.append( QString() );
+        m_stringIndex.insert( QString(), 0 );
+        m_parsed.append( ParsedGroup() );
+    }
+
+    bool isValid() const { return m_valid; }
+    const QVector< ParsedGroup >& groups() const { return m_parsed; }
+    QStringList takeStrings() { return std::move( m_strings ); }
+
+    void OnDocumentStart( const YAML::Mark& ) override {}
+    void OnDocumentEnd() override {}
+
+    void OnNull( const YAML::Mark&, YAML::anchor_t ) override { skipValue(); }
+    void OnAlias( const YAML::Mark& mark, YAML::anchor_t ) override
+    {
+        cWarning() << "netinstall groups data uses an alias at line" << mark.line << "which is not supported.";
+        skipValue();
+    }
+
+    void OnScalar( const YAML::Mark&, const std::string&, YAML::anchor_t, const std::string& value ) override
+    {
+        if ( m_stack.isEmpty() )
+        {
+            return;
+        }
+        const Frame& top = m_stack.last();
+        switch ( top.context )
+        {
+        case Context::Group:
+            if ( !m_haveKey )
+            {
+                m_key = value;
+                m_haveKey = true;
+            }
+            else
+            {
+                setValue( m_parsed[ top.group ], value );
+                m_haveKey = false;
+            }
+            break;
+        case Context::Packages:
+            m_parsed[ top.group ].packages.append( intern( QString::fromStdString( value ) ) );
+            break;
+        case Context::Groups:
+            cWarning() << "netinstall groups data has a non-group entry" << value.c_str();
+            break;
+        case Context::Ignore:
+            break;
+        }
+    }
+
+    void OnSequenceStart( const YAML::Mark&, const std::string&, YAML::anchor_t, YAML::EmitterStyle::value ) override
+    {
+        if ( m_stack.isEmpty() )
+        {
+            // Only the first top-level sequence is the list of groups
+            m_valid = true;
+            push( Context::Groups, 0 );
+            return;
+        }
+        const Frame& top = m_stack.last();
+        if ( top.context == Context::Group && m_haveKey && m_key == "packages" )
+        {
+            push( Context::Packages, top.group );
+        }
+        else if ( top.context == Context::Group && m_haveKey && m_key == "subgroups" )
+        {
+            push( Context::Groups, top.group );
+        }
+        else
+        {
+            push( Context::Ignore, -1 );
+        }
+    }
+    void OnSequenceEnd() override { pop(); }
+
+    void OnMapStart( const YAML::Mark&, const std::string&, YAML::anchor_t, YAML::EmitterStyle::value ) override
+    {
+        if ( !m_stack.isEmpty() && m_stack.last().context == Context::Groups )
+        {
+            const int parent = m_stack.last().group;
+            const int group = m_parsed.count();
+            m_parsed.append( ParsedGroup() );
+            m_parsed[ parent ].subgroups.append( group );
+            push( Context::Group, group );
+        }
+        else
+        {
+            push( Context::Ignore, -1 );
+        }
+    }
+    void OnMapEnd() override { pop(); }
+
+private:
+    enum class Context
+    {
+        Groups,  // A list of groups, group is the parent group
+        Group,  // The keys of a group
+        Packages,  // A list of package names, group is the owner
+        Ignore
+    };
+    struct Frame
+    {
+        Context context;
+        int group;
+    };
+
+    void push( Context c, int group )
+    {
+        m_stack.append( Frame { c, group } );
+        m_haveKey = false;
+    }
+    void pop()
+    {
+        m_stack.removeLast();
+        // A complex value of a group key is done, next is a key again
+        m_haveKey = false;
+    }
+    void skipValue()
+    {
+        if ( !m_stack.isEmpty() && m_stack.last().context == Context::Group )
+        {
+            m_haveKey = false;
+        }
+    }
+
+    int intern( const QString& s )
+    {
+        auto it = m_stringIndex.constFind( s );
+        if ( it != m_stringIndex.constEnd() )
+        {
+            return it.value();
+        }
+        const int index = m_strings.count();
+        m_strings.append( s );
+        m_stringIndex.insert( s, index );
+        return index;
+    }
+
+    static bool toBool( const std::string& value )
+    {
+        return CalamaresUtils::yamlScalarToVariant( YAML::Node( value ) ).toBool();
+    }
+
+    void setValue( ParsedGroup& g, const std::string& value )
+    {
+        if ( m_key == "name" )
+        {
+            g.name = intern( m_translate( QByteArray::fromStdString( value ) ) );
+        }
+        else if ( m_key == "description" )
+        {
+            g.description = intern( m_translate( QByteArray::fromStdString( value ) ) );
+        }
+        else if ( m_key == "pre-install" )
+        {
+            g.preScript = intern( QString::fromStdString( value ) );
+        }
+        else if ( m_key == "post-install" )
+        {
+            g.postScript = intern( QString::fromStdString( value ) );
+        }
+        else if ( m_key == "selected" )
+        {
+            g.selected = toBool( value ) ? 1 : 0;
+        }
+        else if ( m_key == "hidden" )
+        {
+            g.hidden = toBool( value );
+        }
+        else if ( m_key == "critical" )
+        {
+            g.critical = toBool( value );
+        }
+    }
+
+    const PackageTree::Translator& m_translate;
+    bool m_valid;
+    bool m_haveKey;
+    std::string m_key;
+    QVector< Frame > m_stack;
+    QVector< ParsedGroup > m_parsed;
+    QStringList m_strings;
+    QHash< QString, int > m_stringIndex;
+};
+
+PackageTree::PackageTree()
+{
+    m_strings.append( QString() );
+    m_groups.append( Group() );
+
+    Node root;
+    root.group = 0;
+    root.selected = Qt::Checked;
+    m_nodes.append( root );
+}
+
+static Qt::CheckState
+stateFromCounts( const PackageTree::Node& n )
+{
+    if ( n.checkedChildren == n.childCount )
+    {
+        return Qt::Checked;
+    }
+    if ( n.checkedChildren == 0 && n.partialChildren == 0 )
+    {
+        return Qt::Unchecked;
+    }
+    return Qt::PartiallyChecked;
+}
+
+static void
+adjustCounts( PackageTree::Node& parent, Qt::CheckState state, int delta )
+{
+    if ( state == Qt::Checked )
+    {
+        parent.checkedChildren += delta;
+    }
+    else if ( state == Qt::PartiallyChecked )
+    {
+        parent.partialChildren += delta;
+    }
+}
+
+bool
+PackageTree::load( const QByteArray& yamlData, const Translator& translate )
+{
+    GroupsParser handler( translate );
+    {
+        std::istringstream in( yamlData.toStdString() );
+        YAML::Parser parser( in );
+        parser.HandleNextDocument( handler );
+    }
+
+    *this = PackageTree();
+    if ( !handler.isValid() )
+    {
+        cWarning() << "netinstall groups data does not form a sequence.";
+        return false;
+    }
+
+    const auto& parsed = handler.groups();
+    m_strings = handler.takeStrings();
+    m_nodes.reserve( parsed.count() * 4 );
+    m_groups.reserve( parsed.count() );
+
+    // Lay out the tree breadth-first, so that the children of each
+    // group can be given one contiguous block of nodes. Each entry
+    // in the queue is a node index and the parsed group for that node.
+    QVector< QPair< Index, int > > queue;
+    queue.reserve( parsed.count() );
+    queue.append( qMakePair( Index( RootIndex ), 0 ) );
+    for ( int head = 0; head < queue.count(); ++head )
+    {
+        const Index n = queue.at( head ).first;
+        const ParsedGroup& group = parsed.at( queue.at( head ).second );
+        const Qt::CheckState parentState = m_nodes.at( n ).selected;
+
+        auto makeGroup = [&]( int subgroup, int row ) {
+            const ParsedGroup& sub = parsed.at( subgroup );
+            Group g;
+            g.description = sub.description;
+            g.preScript = sub.preScript;
+            g.postScript = sub.postScript;
+            g.critical = sub.critical;
+            g.hidden = sub.hidden;
+
+            Node c;
+            c.parent = n;
+            c.row = row;
+            c.name = sub.name;
+            c.group = m_groups.count();
+            c.selected = sub.selected < 0 ? parentState : ( sub.selected ? Qt::Checked : Qt::Unchecked );
+            m_groups.append( g );
+            m_nodes.append( c );
+            queue.append( qMakePair( Index( m_nodes.count() - 1 ), subgroup ) );
+        };
+
+        const Index first = m_nodes.count();
+        int row = 0;
+        for ( int package : group.packages )
+        {
+            Node c;
+            c.parent = n;
+            c.row = row++;
+            c.name = package;
+            c.selected = parentState;
+            m_nodes.append( c );
+        }
+        for ( int subgroup : group.subgroups )
+        {
+            if ( !parsed.at( subgroup ).hidden )
+            {
+                makeGroup( subgroup, row++ );
+            }
+        }
+        if ( row > 0 )
+        {
+            m_nodes[ n ].firstChild = first;
+            m_nodes[ n ].childCount = row;
+        }
+        for ( int subgroup : group.subgroups )
+        {
+            if ( parsed.at( subgroup ).hidden )
+            {
+                makeGroup( subgroup, 0 );
+                m_hidden.append( m_nodes.count() - 1 );
+            }
+        }
+    }
+
+    // Children come after their parents, so going backwards computes
+    // the state of each group after all of its subgroups, and
+    // each node is counted in its parent before the parent is done.
+    for ( Index i = m_nodes.count() - 1; i > RootIndex; --i )
+    {
+        Node& n = m_nodes[ i ];
+        if ( n.childCount > 0 )
+        {
+            n.selected = stateFromCounts( n );
+        }
+        if ( !isHidden( i ) )
+        {
+            adjustCounts( m_nodes[ n.parent ], n.selected, 1 );
+        }
+    }
+
+    cDebug() << "netinstall loaded" << ( parsed.count() - 1 ) << "groups," << m_nodes.count() << "nodes,"
+             << m_strings.count() << "strings.";
+    return true;
+}
+
+PackageTree::Index
+PackageTree::setSelected( Index i, Qt::CheckState state )
+{
+    if ( i <= RootIndex || i >= count() )
+    {
+        // The root is always checked, so don't change state
+        return InvalidIndex;
+    }
+
+    // All the descendants get the new state, so their counts
+    // follow directly from that state.
+    if ( state != Qt::PartiallyChecked )
+    {
+        QVector< Index > todo { i };
+        while ( !todo.isEmpty() )
+        {
+            const Index n = todo.takeLast();
+            const Index first = m_nodes.at( n ).firstChild;
+            const int childCount = m_nodes.at( n ).childCount;
+            m_nodes[ n ].checkedChildren = state == Qt::Checked ? childCount : 0;
+            m_nodes[ n ].partialChildren = 0;
+            for ( Index c = first; c < first + childCount; ++c )
+            {
+                m_nodes[ c ].selected = state;
+                if ( m_nodes.at( c ).childCount > 0 )
+                {
+                    todo.append( c );
+                }
+            }
+        }
+    }
+
+    Qt::CheckState oldState = m_nodes.at( i ).selected;
+    Qt::CheckState newState = state;
+    m_nodes[ i ].selected = state;
+
+    Index top = i;
+    Index n = i;
+    // Hidden groups are not counted in their parent
+    while ( oldState != newState && !isHidden( n ) )
+    {
+        const Index p = m_nodes.at( n ).parent;
+        if ( p <= RootIndex )
+        {
+            break;
+        }
+
+        Node& parent = m_nodes[ p ];
+        adjustCounts( parent, oldState, -1 );
+        adjustCounts( parent, newState, 1 );
+        oldState = parent.selected;
+        newState = stateFromCounts( parent );
+        parent.selected = newState;
+        if ( oldState != newState )
+        {
+            top = p;
+        }
+        n = p;
+    }
+    return top;
+}
+
+bool
+PackageTree::hiddenSelected( Index i ) const
+{
+    Q_ASSERT( isHidden( i ) );
+    if ( selected( i ) == Qt::Unchecked )
+    {
+        return false;
+    }
+
+    for ( Index p = m_nodes.at( i ).parent; p != InvalidIndex; p = m_nodes.at( p ).parent )
+    {
+        if ( !isHidden( p ) )
+        {
+            return selected( p ) != Qt::Unchecked;
+        }
+    }
+    /* Has no non-hidden parents */
+    return true;
+}
+
+void
+PackageTree::collectPackages( Index parent, QList< ItemData >& packages ) const
+{
+    const Node& p = m_nodes.at( parent );
+    for ( Index c = p.firstChild; c < p.firstChild + p.childCount; ++c )
+    {
+        if ( selected( c ) == Qt::Unchecked )
+        {
+            continue;
+        }
+        if ( isPackage( c ) )
+        {
+            ItemData itemData;
+            itemData.preScript = preScript( parent );  // Only groups have hooks
+            itemData.packageName = name( c );
+            itemData.postScript = postScript( parent );
+            itemData.isCritical = isCritical( parent );  // Only groups are critical
+            packages.append( itemData );
+        }
+        else
+        {
+            collectPackages( c, packages );
+        }
+    }
+}
+
+QList< PackageTree::ItemData >
+PackageTree::packages() const
+{
+    QList< ItemData > packages;
+    collectPackages( RootIndex, packages );
+    for ( Index h : m_hidden )
+    {
+        if ( hiddenSelected( h ) )
+        {
+            collectPackages( h, packages );
+        }
+    }
+    return packages;
+}
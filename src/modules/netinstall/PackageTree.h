@@ -0,0 +1,167 @@
+/* === This file is part of Calamares - <https://github.com/calamares> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Calamares is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Calamares is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Calamares. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef NETINSTALL_PACKAGETREE_H
+#define NETINSTALL_PACKAGETREE_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <functional>
+
+/** @brief Compact tree of netinstall groups and packages
+ *
+ * All the nodes of the tree live in one vector, and refer to each
+ * other by index. The children of a node are contiguous in that vector,
+ * so a node only stores its first child and the number of children.
+ * Each distinct string (package name, description, script) is stored
+ * once, and nodes refer to strings by index as well.
+ *
+ * Node 0 is the root, which is always checked. Hidden groups are
+ * nodes too, but they are not counted among the children of their
+ * parent; they are listed separately (see hiddenGroups()).
+ */
+class PackageTree
+{
+public:
+    using Index = int;
+    enum : Index
+    {
+        RootIndex = 0,
+        InvalidIndex = -1
+    };
+
+    /// @brief Information about one package, as returned by packages()
+    struct ItemData
+    {
+        QString name;
+        QString description;
+        QString preScript;
+        QString packageName;
+        QString postScript;
+        bool isCritical = false;
+        bool isHidden = false;
+        Qt::CheckState selected = Qt::Unchecked;
+    };
+
+    struct Node
+    {
+        Index parent = InvalidIndex;
+        Index firstChild = InvalidIndex;  ///< Children are [firstChild .. firstChild + childCount)
+        int childCount = 0;
+        int row = 0;  ///< Position among the children of the parent
+        int name = 0;  ///< Package name (for packages) or group name (for groups)
+        int group = -1;  ///< Index into the group data, or -1 for packages
+        Qt::CheckState selected = Qt::Unchecked;
+        int checkedChildren = 0;  ///< Number of children that are Checked
+        int partialChildren = 0;  ///< Number of children that are PartiallyChecked
+    };
+
+    /// @brief Translates group names and descriptions while loading
+    using Translator = std::function< QString( const QByteArray& ) >;
+
+    /// @brief An empty tree, with just the (checked) root
+    PackageTree();
+
+    /** @brief Load groups data (YAML) into the tree
+     *
+     * The data is parsed as a stream of events: there is no intermediate
+     * YAML document. See the README.md of the netinstall module for the
+     * format of the data. Returns false (and leaves the tree empty)
+     * if the data does not form a list of groups. Syntax errors in the YAML
+     * data throw a YAML::Exception.
+     *
+     * Group names and descriptions are passed through @p translate.
+     */
+    bool load( const QByteArray& yamlData, const Translator& translate );
+
+    /// @brief Number of nodes, including the root and hidden groups
+    int count() const { return m_nodes.count(); }
+    const Node& node( Index i ) const { return m_nodes.at( i ); }
+    Index child( Index parent, int row ) const { return m_nodes.at( parent ).firstChild + row; }
+    const QVector< Index >& hiddenGroups() const { return m_hidden; }
+
+    bool isPackage( Index i ) const { return m_nodes.at( i ).group < 0; }
+    bool isHidden( Index i ) const { return !isPackage( i ) && m_groups.at( m_nodes.at( i ).group ).hidden; }
+    bool isCritical( Index i ) const { return !isPackage( i ) && m_groups.at( m_nodes.at( i ).group ).critical; }
+
+    /// @brief Package name (for packages) or (translated) group name
+    QString name( Index i ) const { return m_strings.at( m_nodes.at( i ).name ); }
+    QString description( Index i ) const { return groupString( i, &Group::description ); }
+    QString preScript( Index i ) const { return groupString( i, &Group::preScript ); }
+    QString postScript( Index i ) const { return groupString( i, &Group::postScript ); }
+
+    Qt::CheckState selected( Index i ) const { return m_nodes.at( i ).selected; }
+    /** @brief Changes the selected-state of a node
+     *
+     * The new state is applied to all the descendants of the
+     * node, and the state of the ancestors is re-computed
+     * from their children. The root cannot be changed.
+     *
+     * Each group keeps count of its checked and partially-checked
+     * children, so each ancestor is updated in constant time, and
+     * the walk up stops at the first ancestor that does not change.
+     *
+     * Returns the top-most node whose state changed (which is @p i
+     * unless an ancestor changed as well), or InvalidIndex if
+     * nothing was done.
+     */
+    Index setSelected( Index i, Qt::CheckState state );
+
+    /** @brief Is this hidden group, considered "selected"?
+     *
+     * A hidden group has its own selected state, but really
+     * falls under the selectedness of the nearest non-hidden ancestor.
+     */
+    bool hiddenSelected( Index i ) const;
+
+    /** @brief The selected packages
+     *
+     * Returns the packages that are selected in the visible part of the
+     * tree, and the packages of hidden groups that count as selected.
+     * Each entry carries the scripts and criticality of its group.
+     */
+    QList< ItemData > packages() const;
+
+private:
+    struct Group
+    {
+        int description = 0;
+        int preScript = 0;
+        int postScript = 0;
+        bool critical = false;
+        bool hidden = false;
+    };
+
+    QString groupString( Index i, int Group::*field ) const
+    {
+        return isPackage( i ) ? QString() : m_strings.at( m_groups.at( m_nodes.at( i ).group ).*field );
+    }
+    void collectPackages( Index parent, QList< ItemData >& packages ) const;
+
+    QVector< Node > m_nodes;
+    QVector< Group > m_groups;
+    QVector< Index > m_hidden;
+    QStringList m_strings;  ///< String 0 is always the empty string
+};
+
+#endif  // NETINSTALL_PACKAGETREE_H
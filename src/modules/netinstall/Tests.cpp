@@ -0,0 +1,238 @@
+/* === This file is part of Calamares - <https://github.com/calamares> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Calamares is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Calamares is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Calamares. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Tests.h"
+
+#include "GroupsCache.h"
+#include "PackageTree.h"
+
+#include "utils/Logger.h"
+#include "utils/Yaml.h"
+
+#include <QtTest/QtTest>
+
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+QTEST_GUILESS_MAIN( NetInstallTests )
+
+static QString
+identity( const QByteArray& s )
+{
+    return QString::fromUtf8( s );
+}
+
+static const char groupsData[] = R"(---
+- name: "Base"
+  description: "Base system"
+  hidden: true
+  selected: true
+  critical: true
+  packages: [ base, linux ]
+- name: "Desktop"
+  description: "Desktop environments"
+  selected: false
+  post-install: "echo done"
+  packages: [ xorg ]
+  subgroups:
+    - name: "KDE"
+      description: "Plasma"
+      selected: true
+      unknown-key: { ignored: [ 1, 2 ] }
+      packages: [ plasma, dolphin ]
+    - name: "GNOME"
+      description: "GNOME Shell"
+      packages: [ gnome ]
+)";
+
+NetInstallTests::NetInstallTests() {}
+
+NetInstallTests::~NetInstallTests() {}
+
+void
+NetInstallTests::initTestCase()
+{
+    Logger::setupLogLevel( Logger::LOGDEBUG );
+}
+
+void
+NetInstallTests::testSampleGroups()
+{
+    QByteArray data;
+    QStringList dirs { "src/modules/netinstall", "." };
+    for ( const auto& dir : dirs )
+    {
+        QFile f( dir + "/netinstall.yaml" );
+        if ( f.open( QIODevice::ReadOnly ) )
+        {
+            data = f.readAll();
+            break;
+        }
+    }
+    QVERIFY( !data.isEmpty() );
+
+    PackageTree tree;
+    QVERIFY( tree.load( data, identity ) );
+    QCOMPARE( tree.node( PackageTree::RootIndex ).childCount, 3 );
+    QCOMPARE( tree.hiddenGroups().count(), 1 );
+    QCOMPARE( tree.name( tree.hiddenGroups().first() ), QStringLiteral( "Default" ) );
+    QCOMPARE( tree.name( tree.child( PackageTree::RootIndex, 0 ) ), QStringLiteral( "Wireless" ) );
+}
+
+void
+NetInstallTests::testTree()
+{
+    PackageTree tree;
+    QVERIFY( tree.load( QByteArray( groupsData ), identity ) );
+
+    QCOMPARE( tree.node( PackageTree::RootIndex ).childCount, 1 );
+    QCOMPARE( tree.hiddenGroups().count(), 1 );
+
+    const auto desktop = tree.child( PackageTree::RootIndex, 0 );
+    QCOMPARE( tree.name( desktop ), QStringLiteral( "Desktop" ) );
+    QCOMPARE( tree.description( desktop ), QStringLiteral( "Desktop environments" ) );
+    QCOMPARE( tree.postScript( desktop ), QStringLiteral( "echo done" ) );
+    QVERIFY( !tree.isPackage( desktop ) );
+    QCOMPARE( tree.node( desktop ).childCount, 3 );
+
+    // Packages come before subgroups
+    const auto xorg = tree.child( desktop, 0 );
+    const auto kde = tree.child( desktop, 1 );
+    const auto gnome = tree.child( desktop, 2 );
+    QVERIFY( tree.isPackage( xorg ) );
+    QCOMPARE( tree.name( xorg ), QStringLiteral( "xorg" ) );
+    QCOMPARE( tree.node( kde ).parent, desktop );
+    QCOMPARE( tree.node( gnome ).row, 2 );
+    QCOMPARE( tree.name( tree.child( kde, 1 ) ), QStringLiteral( "dolphin" ) );
+
+    // Selection is inherited, and groups reflect their children
+    QCOMPARE( tree.selected( xorg ), Qt::Unchecked );
+    QCOMPARE( tree.selected( kde ), Qt::Checked );
+    QCOMPARE( tree.selected( tree.child( kde, 0 ) ), Qt::Checked );
+    QCOMPARE( tree.selected( gnome ), Qt::Unchecked );
+    QCOMPARE( tree.selected( desktop ), Qt::PartiallyChecked );
+
+    const auto base = tree.hiddenGroups().first();
+    QVERIFY( tree.isHidden( base ) );
+    QVERIFY( tree.isCritical( base ) );
+    QVERIFY( tree.hiddenSelected( base ) );
+
+    const auto packages = tree.packages();
+    QCOMPARE( packages.count(), 4 );
+    QCOMPARE( packages.at( 0 ).packageName, QStringLiteral( "plasma" ) );
+    QVERIFY( !packages.at( 0 ).isCritical );
+    QCOMPARE( packages.at( 2 ).packageName, QStringLiteral( "base" ) );
+    QVERIFY( packages.at( 2 ).isCritical );
+}
+
+void
+NetInstallTests::testSelection()
+{
+    PackageTree tree;
+    QVERIFY( tree.load( QByteArray( groupsData ), identity ) );
+
+    const auto desktop = tree.child( PackageTree::RootIndex, 0 );
+    const auto kde = tree.child( desktop, 1 );
+    const auto gnome = tree.child( desktop, 2 );
+
+    tree.setSelected( desktop, Qt::Checked );
+    QCOMPARE( tree.selected( gnome ), Qt::Checked );
+    QCOMPARE( tree.selected( tree.child( gnome, 0 ) ), Qt::Checked );
+    QCOMPARE( tree.packages().count(), 6 );
+
+    // Desktop was checked and becomes partial, so it is the top-most change
+    QCOMPARE( tree.setSelected( tree.child( kde, 0 ), Qt::Unchecked ), desktop );
+    QCOMPARE( tree.selected( kde ), Qt::PartiallyChecked );
+    QCOMPARE( tree.node( kde ).checkedChildren, 1 );
+    QCOMPARE( tree.node( desktop ).partialChildren, 1 );
+    QCOMPARE( tree.selected( desktop ), Qt::PartiallyChecked );
+    QCOMPARE( tree.packages().count(), 5 );
+
+    // KDE changes, but Desktop stays partial
+    QCOMPARE( tree.setSelected( tree.child( kde, 1 ), Qt::Unchecked ), kde );
+    tree.setSelected( tree.child( desktop, 0 ), Qt::Unchecked );
+    tree.setSelected( gnome, Qt::Unchecked );
+    QCOMPARE( tree.selected( kde ), Qt::Unchecked );
+    QCOMPARE( tree.selected( desktop ), Qt::Unchecked );
+    QCOMPARE( tree.packages().count(), 2 );  // Only the hidden group
+
+    // The root does not change
+    QCOMPARE( tree.setSelected( PackageTree::RootIndex, Qt::Unchecked ), PackageTree::Index( PackageTree::InvalidIndex ) );
+    QCOMPARE( tree.selected( PackageTree::RootIndex ), Qt::Checked );
+}
+
+void
+NetInstallTests::testBadData()
+{
+    PackageTree tree;
+    QVERIFY( !tree.load( QByteArray( "name: not-a-list\n" ), identity ) );
+    QCOMPARE( tree.count(), 1 );
+    QVERIFY( !tree.load( QByteArray( "just a string\n" ), identity ) );
+
+    // Non-group entries are skipped
+    QVERIFY( tree.load( QByteArray( "- just a string\n- name: \"Group\"\n  packages: [ a ]\n" ), identity ) );
+    QCOMPARE( tree.node( PackageTree::RootIndex ).childCount, 1 );
+
+    QVERIFY_EXCEPTION_THROWN( tree.load( QByteArray( "- name: [ unterminated\n" ), identity ), YAML::Exception );
+}
+
+void
+NetInstallTests::testCache()
+{
+    QTemporaryDir dir;
+    QVERIFY( dir.isValid() );
+    const QString path = dir.filePath( "groups.yaml" );
+    const QByteArray data( "- name: \"Group\"\n  packages: [ a ]\n" );
+
+    GroupsCache none;
+    QVERIFY( !none.isValid() );
+    QVERIFY( !none.load() );
+
+    GroupsCache cache( path );
+    QVERIFY( cache.isValid() );
+    QVERIFY( !cache.load() );  // Nothing there yet
+
+    const QUrl url( "http://example.com/groups.yaml" );
+    QVERIFY( cache.save( data, url, "\"abc\"", "Tue, 01 Oct 2019 10:00:00 GMT" ) );
+
+    GroupsCache reread( path );
+    QVERIFY( reread.load() );
+    QCOMPARE( reread.data(), data );
+    QCOMPARE( reread.url(), url );
+    QCOMPARE( reread.etag(), QByteArray( "\"abc\"" ) );
+    QCOMPARE( reread.lastModified(), QByteArray( "Tue, 01 Oct 2019 10:00:00 GMT" ) );
+    QCOMPARE( reread.checksum(), GroupsCache::checksum( data ) );
+    QCOMPARE( reread.checksum().length(), 64 );
+
+    // Tampering with the data is noticed
+    {
+        QFile f( path );
+        QVERIFY( f.open( QIODevice::Append ) );
+        f.write( "- name: \"Other\"\n" );
+    }
+    QVERIFY( !reread.load() );
+    QVERIFY( reread.data().isEmpty() );
+
+    // Without meta file, the data is accepted as shipped
+    QVERIFY( QFile::remove( path + ".meta" ) );
+    QVERIFY( reread.load() );
+    QVERIFY( reread.url().isEmpty() );
+    QVERIFY( reread.etag().isEmpty() );
+}
@@ -0,0 +1,46 @@
+/* === This file is part of Calamares - <https://github.com/calamares> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Calamares is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Calamares is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Calamares. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TESTS_H
+#define TESTS_H
+
+#include <QObject>
+
+class NetInstallTests : public QObject
+{
+    Q_OBJECT
+public:
+    NetInstallTests();
+    ~NetInstallTests() override;
+
+private Q_SLOTS:
+    void initTestCase();
+    // Check the sample groups file is loaded correctly
+    void testSampleGroups();
+    // Check layout, inherited selection and hidden groups
+    void testTree();
+    // Check that selection changes propagate up and down
+    void testSelection();
+    // Check that bad data is rejected
+    void testBadData();
+    // Check that the cache round-trips and rejects modified data
+    void testCache();
+};
+
+#endif
@@ -30,6 +30,7 @@
 #include <kpmcore/core/device.h>
 #include <kpmcore/core/partition.h>
 
+#include <partition/DeviceInventory.h>
 #include <utils/Logger.h>
 #include <JobQueue.h>
 #include <GlobalStorage.h>
@@ -56,6 +57,12 @@ hasRootPartition( Device* device )
 static bool
 blkIdCheckIso9660( const QString& path )
 {
+    // The shared inventory has run blkid once, for all the devices,
+    // instead of once for each device and partition here.
+    using CalamaresUtils::Partition::DeviceInventory;
+    if ( DeviceInventory::isSupported() )
+        return DeviceInventory::instance().filesystemType( path ) == QLatin1String( "iso9660" );
+
     QProcess blkid;
     blkid.start( "blkid", { path } );
     blkid.waitForFinished();
@@ -31,6 +31,7 @@
 #include "core/PartitionModel.h"
 #include "core/KPMHelpers.h"
 #include "core/PartUtils.h"
+#include "partition/DeviceInventory.h"
 #include "jobs/ClearMountsJob.h"
 #include "jobs/ClearTempMountsJob.h"
 #include "jobs/CreatePartitionJob.h"
@@ -885,6 +886,8 @@ PartitionCoreModule::revert()
     QMutexLocker locker( &m_revertMutex );
     qDeleteAll( m_deviceInfos );
     m_deviceInfos.clear();
+    // Devices may have been plugged in since the last scan
+    CalamaresUtils::Partition::DeviceInventory::instance().refresh();
     doInit();
     updateIsDirty();
     emit reverted();
@@ -35,28 +35,70 @@ def pretty_name():
     return _("Configure systemd services")
 
 
+def systemctl_failure(name, command, suffix, ec):
+    """
+    Returns the failure message for a (mandatory) unit @p name,
+    for which "systemctl <command>" returned @p ec.
+    """
+    title = _("Cannot modify service")
+    diagnostic = _("<code>systemctl {arg!s}</code> call in chroot returned error code {num!s}.").format(arg=command, num=ec)
+
+    if command == "enable" and suffix == ".service":
+        description = _("Cannot enable systemd service <code>{name!s}</code>.")
+    elif command == "enable" and suffix == ".target":
+        description = _("Cannot enable systemd target <code>{name!s}</code>.")
+    elif command == "disable" and suffix == ".service":
+        description = _("Cannot enable systemd service <code>{name!s}</code>.")
+    elif command == "disable" and suffix == ".target":
+        description = _("Cannot disable systemd target <code>{name!s}</code>.")
+    elif command == "mask":
+        description = _("Cannot mask systemd unit <code>{name!s}</code>.")
+    else:
+        description = _("Unknown systemd commands <code>{command!s}</code> and <code>{suffix!s}</code> for unit {name!s}.")
+
+    return (title,
+            description.format(name=name, command=command, suffix=suffix) + " " + diagnostic
+            )
+
+
 def systemctl(targets, command, suffix):
     """
-    For each entry in @p targets, run "systemctl <command> <thing>",
-    where <thing> is the entry's name plus the given @p suffix.
+    For all the entries in @p targets, run "systemctl <command> <things>",
+    where each <thing> is the entry's name plus the given @p suffix.
     (No dot is added between name and suffix; suffix may be empty)
 
+    All the units are passed to a single systemctl call. If that
+    fails, each unit is tried on its own to find out which one(s)
+    failed; those calls are submitted as one batch.
+
     Returns a failure message, or None if this was successful.
     Services that are not mandatory have their failures suppressed
     silently.
     """
+    units = []
     for svc in targets:
         if isinstance(svc, str):
-            name = svc
-            mandatory = False
+            units.append((svc, False))
         else:
-            name = svc["name"]
-            mandatory = svc.get("mandatory", False)
+            units.append((svc["name"], svc.get("mandatory", False)))
 
-        ec = libcalamares.utils.target_env_call(
-            ['systemctl', command, "{}{}".format(name, suffix)]
-            )
+    if not units:
+        return None
+
+    ec = libcalamares.utils.target_env_call(
+        ['systemctl', command] + ["{}{}".format(name, suffix) for name, _mandatory in units]
+        )
+    if ec == 0:
+        return None
+
+    libcalamares.utils.debug(
+        "systemctl {} of {} units returned error code {}, trying units one by one".format(command, len(units), ec)
+        )
+    results = libcalamares.utils.target_env_call_batch(
+        [['systemctl', command, "{}{}".format(name, suffix)] for name, _mandatory in units]
+        )
 
+    for (name, mandatory), ec in zip(units, results):
         if ec != 0:
             libcalamares.utils.warning(
                 "Cannot {} systemd {} {}".format(command, suffix, name)
@@ -65,25 +107,7 @@ def systemctl(targets, command, suffix):
                 "systemctl {} call in chroot returned error code {}".format(command, ec)
                 )
             if mandatory:
-                title = _("Cannot modify service")
-                diagnostic = _("<code>systemctl {arg!s}</code> call in chroot returned error code {num!s}.").format(arg=command, num=ec)
-
-                if command == "enable" and suffix == ".service":
-                    description = _("Cannot enable systemd service <code>{name!s}</code>.")
-                elif command == "enable" and suffix == ".target":
-                    description = _("Cannot enable systemd target <code>{name!s}</code>.")
-                elif command == "disable" and suffix == ".service":
-                    description = _("Cannot enable systemd service <code>{name!s}</code>.")
-                elif command == "disable" and suffix == ".target":
-                    description = _("Cannot disable systemd target <code>{name!s}</code>.")
-                elif command == "mask":
-                    description = _("Cannot mask systemd unit <code>{name!s}</code>.")
-                else:
-                    description = _("Unknown systemd commands <code>{command!s}</code> and <code>{suffix!s}</code> for unit {name!s}.")
-
-                return (title,
-                        description.format(name=name, command=command, suffix=suffix) + " " + diagnostic
-                        )
+                return systemctl_failure(name, command, suffix, ec)
     return None
 
 
@@ -61,7 +61,7 @@ ShellProcessJob::exec()
         return Calamares::JobResult::ok();
     }
 
-    return m_commands->run();
+    return m_commands->run( [this]( qreal p ) { emit progress( p ); } );
 }
 
 
@@ -30,6 +30,7 @@
 
 #include <QFileInfo>
 #include <QStringList>
+#include <QTemporaryDir>
 
 QTEST_GUILESS_MAIN( ShellProcessTests )
 
@@ -210,3 +211,84 @@ script:
     gs->insert( "username", "`id -u`" );
     QVERIFY( bool( CommandList( userScript, false, 10s ).run() ) );
 }
+
+void
+ShellProcessTests::testProgressPattern()
+{
+    YAML::Node doc = YAML::Load( R"(---
+script:
+    - command: "printf 'step 1\\nhalf: 50%%\\nstep 2\\n'"
+      progress: "half: ([0-9]+)%"
+    - "true"
+)" );
+    CommandList cl( CalamaresUtils::yamlMapToVariant( doc ).toMap().value( "script" ), false, 10s );
+    QCOMPARE( cl.count(), 2 );
+
+    auto parser = cl.at( 0 ).progressParser();
+    QVERIFY( bool( parser ) );
+    QVERIFY( !bool( cl.at( 1 ).progressParser() ) );
+    QCOMPARE( parser( QStringLiteral( "half: 50%" ) ), 0.5 );
+    QVERIFY( parser( QStringLiteral( "step 1" ) ) < 0 );
+
+    if ( !Calamares::JobQueue::instance() )
+        (void)new Calamares::JobQueue( nullptr );
+
+    QList< qreal > reported;
+    QVERIFY( bool( cl.run( [&reported]( qreal p ) { reported.append( p ); } ) ) );
+    // Half of the first command, then each command when it is done
+    QCOMPARE( reported, QList< qreal >( { 0.25, 0.5, 1.0 } ) );
+}
+
+void
+ShellProcessTests::testParallelGroup()
+{
+    // Each of the two commands leaves a marker, and then waits (for
+    // a bounded time) for the marker of the other one; they only
+    // both succeed if they run at the same time.
+    QTemporaryDir markers;
+    QVERIFY( markers.isValid() );
+    const QString waitFor = QStringLiteral(
+        "touch %1/%2; i=0; while [ ! -e %1/%3 ] && [ $i -lt 50 ]; do sleep 0.1; i=$((i+1)); done; [ -e %1/%3 ]" );
+    const QString first = waitFor.arg( markers.path(), QStringLiteral( "a" ), QStringLiteral( "b" ) );
+    const QString second = waitFor.arg( markers.path(), QStringLiteral( "b" ), QStringLiteral( "a" ) );
+
+    YAML::Node doc = YAML::Load( QStringLiteral( R"(---
+script:
+    - "true"
+    - parallel:
+        - '%1'
+        - "-false"
+        - command: '%2'
+          timeout: 20
+      limit: 2
+    - "true"
+)" ).arg( first, second ).toStdString() );
+    CommandList cl( CalamaresUtils::yamlMapToVariant( doc ).toMap().value( "script" ), false, 10s );
+    QCOMPARE( cl.count(), 5 );
+    QCOMPARE( cl.at( 0 ).group(), 0 );
+    QVERIFY( cl.at( 1 ).group() != 0 );
+    QCOMPARE( cl.at( 2 ).group(), cl.at( 1 ).group() );
+    QCOMPARE( cl.at( 3 ).group(), cl.at( 1 ).group() );
+    QCOMPARE( cl.at( 3 ).groupLimit(), 2 );
+    QCOMPARE( cl.at( 3 ).timeout(), 20s );
+    QCOMPARE( cl.at( 4 ).group(), 0 );
+
+    if ( !Calamares::JobQueue::instance() )
+        (void)new Calamares::JobQueue( nullptr );
+
+    // The two waits overlap, and the failure is ignored
+    QVERIFY( bool( cl.run() ) );
+    QVERIFY( QFileInfo::exists( markers.path() + "/a" ) );
+    QVERIFY( QFileInfo::exists( markers.path() + "/b" ) );
+
+    // A failure in a group fails the list, after the whole group has run
+    doc = YAML::Load( R"(---
+script:
+    - parallel:
+        - "false"
+        - "true"
+)" );
+    CommandList failing( CalamaresUtils::yamlMapToVariant( doc ).toMap().value( "script" ), false, 10s );
+    QCOMPARE( failing.count(), 2 );
+    QVERIFY( !bool( failing.run() ) );
+}
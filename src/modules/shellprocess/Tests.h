@@ -42,6 +42,10 @@ private Q_SLOTS:
     void testProcessListFromObject();
     // Check @@ROOT@@ substitution
     void testRootSubstitution();
+    // Progress read from the output of commands
+    void testProgressPattern();
+    // Groups of commands that run concurrently
+    void testParallelGroup();
 };
 
 #endif
@@ -19,6 +19,8 @@
 
 #include <CreateUserJob.h>
 
+#include "UserDatabase.h"
+
 #include "JobQueue.h"
 #include "GlobalStorage.h"
 #include "utils/Logger.h"
@@ -32,6 +34,28 @@
 #include <QTextStream>
 
 
+/** @brief Adds the user, and the groups, to @p db (in memory)
+ *
+ * Returns false if the database can't do it; then the tools are
+ * used instead.
+ */
+static bool
+addToDatabase( UserDatabase& db,
+               const QString& userName,
+               const QString& fullName,
+               const QStringList& groups,
+               const QString& home,
+               const QString& shell )
+{
+    foreach ( const QString& group, groups )
+        if ( db.addGroup( group ) < 0 )
+            return false;
+
+    return db.addUser( userName, fullName, home, shell ) >= 0 &&
+           db.addToGroups( userName, groups );
+}
+
+
 CreateUserJob::CreateUserJob( const QString& userName,
                               const QString& fullName,
                               bool autologin,
@@ -93,36 +117,10 @@ CreateUserJob::exec()
             return Calamares::JobResult::error( tr( "Cannot chmod sudoers file." ) );
     }
 
-    QFileInfo groupsFi( destDir.absoluteFilePath( "etc/group" ) );
-    QFile groupsFile( groupsFi.absoluteFilePath() );
-    if ( !groupsFile.open( QIODevice::ReadOnly | QIODevice::Text ) )
-        return Calamares::JobResult::error( tr( "Cannot open groups file for reading." ) );
-    QString groupsData = QString::fromLocal8Bit( groupsFile.readAll() );
-    QStringList groupsLines = groupsData.split( '\n' );
-    for ( QStringList::iterator it = groupsLines.begin();
-          it != groupsLines.end(); ++it )
-    {
-        int indexOfFirstToDrop = it->indexOf( ':' );
-        it->truncate( indexOfFirstToDrop );
-    }
-
-    foreach ( const QString& group, m_defaultGroups )
-        if ( !groupsLines.contains( group ) )
-            CalamaresUtils::System::instance()->
-                    targetEnvCall( { "groupadd", group } );
-
-    QString defaultGroups = m_defaultGroups.join( ',' );
-    if ( m_autologin )
-    {
-        QString autologinGroup;
-        if ( gs->contains( "autologinGroup" ) &&
-                !gs->value( "autologinGroup" ).toString().isEmpty() )
-        {
-            autologinGroup = gs->value( "autologinGroup" ).toString();
-            CalamaresUtils::System::instance()->targetEnvCall( { "groupadd", autologinGroup } );
-            defaultGroups.append( QString( ",%1" ).arg( autologinGroup ) );
-        }
-    }
+    QStringList groups = m_defaultGroups;
+    if ( m_autologin && gs->contains( "autologinGroup" ) &&
+         !gs->value( "autologinGroup" ).toString().isEmpty() )
+        groups << gs->value( "autologinGroup" ).toString();
 
     // If we're looking to reuse the contents of an existing /home
     if ( gs->value( "reuseHome" ).toBool() )
@@ -147,8 +145,60 @@ CreateUserJob::exec()
         }
     }
 
-    QStringList useradd{ "useradd", "-m", "-U" };
     QString shell = gs->value( "userShell" ).toString();
+    QString homeDir = QString( "/home/%1" ).arg( m_userName );
+
+    UserDatabase db( destDir.absolutePath() );
+    if ( db.load() && addToDatabase( db, m_userName, m_fullName, groups, homeDir, shell ) )
+    {
+        if ( !db.save() )
+            return Calamares::JobResult::error( tr( "Cannot write the user database." ) );
+
+        // The home directory is owned by the user as it is filled,
+        // or after the fact if it is re-used.
+        QString hostHome = destDir.absolutePath() + homeDir;
+        uid_t uid = uid_t( db.uid( m_userName ) );
+        gid_t gid = gid_t( db.gid( m_userName ) );
+        bool ok = QFileInfo::exists( hostHome )
+                  ? changeOwnerRecursive( hostHome, uid, gid )
+                  : createHome( hostHome, db.skeleton(), uid, gid, db.homeMode() );
+        if ( !ok )
+            return Calamares::JobResult::error( tr( "Cannot create home directory for user %1." ).arg( m_userName ) );
+        return Calamares::JobResult::ok();
+    }
+
+    cDebug() << "Creating user" << m_userName << "with useradd instead.";
+    return createWithTools( groups, shell );
+}
+
+
+Calamares::JobResult
+CreateUserJob::createWithTools( const QStringList& groups, const QString& shell )
+{
+    Calamares::GlobalStorage* gs = Calamares::JobQueue::instance()->globalStorage();
+    QDir destDir( gs->value( "rootMountPoint" ).toString() );
+
+    QFileInfo groupsFi( destDir.absoluteFilePath( "etc/group" ) );
+    QFile groupsFile( groupsFi.absoluteFilePath() );
+    if ( !groupsFile.open( QIODevice::ReadOnly | QIODevice::Text ) )
+        return Calamares::JobResult::error( tr( "Cannot open groups file for reading." ) );
+    QString groupsData = QString::fromLocal8Bit( groupsFile.readAll() );
+    QStringList groupsLines = groupsData.split( '\n' );
+    for ( QStringList::iterator it = groupsLines.begin();
+          it != groupsLines.end(); ++it )
+    {
+        int indexOfFirstToDrop = it->indexOf( ':' );
+        it->truncate( indexOfFirstToDrop );
+    }
+
+    foreach ( const QString& group, groups )
+        if ( !groupsLines.contains( group ) )
+            CalamaresUtils::System::instance()->
+                    targetEnvCall( { "groupadd", group } );
+
+    QString defaultGroups = groups.join( ',' );
+
+    QStringList useradd{ "useradd", "-m", "-U" };
     if ( !shell.isEmpty() )
         useradd << "-s" << shell;
     useradd << "-c" << m_fullName;
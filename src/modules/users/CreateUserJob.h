@@ -37,6 +37,9 @@ public:
     Calamares::JobResult exec() override;
 
 private:
+    /// @brief Creates the user with groupadd, useradd and usermod
+    Calamares::JobResult createWithTools( const QStringList& groups, const QString& shell );
+
     QString m_userName;
     QString m_fullName;
     bool m_autologin;
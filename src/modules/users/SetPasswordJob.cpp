@@ -19,6 +19,8 @@
 
 #include <SetPasswordJob.h>
 
+#include "UserDatabase.h"
+
 #include "JobQueue.h"
 #include "GlobalStorage.h"
 #include "utils/Logger.h"
@@ -112,9 +114,17 @@ SetPasswordJob::exec()
         return Calamares::JobResult::error( tr( "Bad destination system path." ),
                                             tr( "rootMountPoint is %1" ).arg( destDir.absolutePath() ) );
 
+    // The password is written directly into /etc/shadow when possible
+    UserDatabase db( destDir.absolutePath() );
+    bool haveDatabase = db.load();
+
     if ( m_userName == "root" &&
          m_newPassword.isEmpty() ) //special case for disabling root account
     {
+        // Like passwd -dl, no password and locked
+        if ( haveDatabase && db.setPassword( m_userName, QStringLiteral( "!" ) ) && db.save() )
+            return Calamares::JobResult::ok();
+
         int ec = CalamaresUtils::System::instance()->
                  targetEnvCall( { "passwd",
                                   "-dl",
@@ -130,6 +140,9 @@ SetPasswordJob::exec()
                             crypt( m_newPassword.toUtf8(),
                                    make_salt( 16 ).toUtf8() ) );
 
+    if ( haveDatabase && db.setPassword( m_userName, encrypted ) && db.save() )
+        return Calamares::JobResult::ok();
+
     int ec = CalamaresUtils::System::instance()->
                           targetEnvCall( { "usermod",
                                            "-p",
@@ -0,0 +1,662 @@
+/* === This file is part of Calamares - <https://github.com/calamares> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Calamares is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Calamares is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Calamares. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "UserDatabase.h"
+
+#include "utils/Logger.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/xattr.h>
+#include <unistd.h>
+
+/** @brief Reads settings from @p path, which has a key and value per line
+ *
+ * In /etc/login.defs they are separated by whitespace, in
+ * /etc/default/useradd by @p separator '='.
+ */
+static QHash< QString, QString >
+readSettings( const QString& path, char separator )
+{
+    QHash< QString, QString > settings;
+    QFile f( path );
+    if ( !f.open( QIODevice::ReadOnly | QIODevice::Text ) )
+    {
+        return settings;
+    }
+
+    for ( const QByteArray& rawLine : f.readAll().split( '\n' ) )
+    {
+        const QString line = QString::fromLocal8Bit( rawLine ).trimmed();
+        if ( line.isEmpty() || line.startsWith( '#' ) )
+        {
+            continue;
+        }
+        int split = line.indexOf( separator );
+        if ( separator == ' ' && split < 0 )
+        {
+            split = line.indexOf( '\t' );
+        }
+        if ( split > 0 )
+        {
+            settings.insert( line.left( split ).trimmed(), line.mid( split + 1 ).trimmed() );
+        }
+    }
+    return settings;
+}
+
+/// @brief Index of the entry for @p name in @p entries, or -1
+static int
+findEntry( const QList< QStringList >& entries, const QString& name )
+{
+    for ( int i = 0; i < entries.count(); ++i )
+    {
+        if ( entries.at( i ).first() == name )
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/// @brief The id (uid or gid, the third field) of @p name in @p entries, or -1
+static int
+idOf( const QList< QStringList >& entries, const QString& name )
+{
+    const int i = findEntry( entries, name );
+    bool ok = false;
+    const int id = ( i >= 0 && entries.at( i ).count() > 2 ) ? entries.at( i ).at( 2 ).toInt( &ok ) : -1;
+    return ok ? id : -1;
+}
+
+/// @brief Is @p id used in the third field (uid or gid) of any of the @p entries?
+static bool
+isIdUsed( const QList< QStringList >& entries, int id )
+{
+    const QString s = QString::number( id );
+    for ( const auto& e : entries )
+    {
+        if ( e.count() > 2 && e.at( 2 ) == s )
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/** @brief Picks a new id from the range @p min to @p max
+ *
+ * Like useradd, this takes one more than the highest id in use in
+ * the range, and only looks for a gap if that is out of range.
+ */
+static int
+nextId( const QList< QStringList >& entries, int min, int max )
+{
+    QSet< int > used;
+    int highest = min - 1;
+    for ( const auto& e : entries )
+    {
+        bool ok = false;
+        const int id = e.count() > 2 ? e.at( 2 ).toInt( &ok ) : -1;
+        if ( ok && id >= min && id <= max )
+        {
+            used.insert( id );
+            highest = qMax( highest, id );
+        }
+    }
+    if ( highest < max )
+    {
+        return highest + 1;
+    }
+    for ( int id = min; id <= max; ++id )
+    {
+        if ( !used.contains( id ) )
+        {
+            return id;
+        }
+    }
+    return -1;
+}
+
+/// @brief Days since the epoch, as used in /etc/shadow
+static QString
+today()
+{
+    return QString::number( QDateTime::currentDateTimeUtc().toSecsSinceEpoch() / ( 24 * 60 * 60 ) );
+}
+
+UserDatabase::UserDatabase( const QString& root )
+    : m_root( root )
+{
+    m_passwd.path = QStringLiteral( "/etc/passwd" );
+    m_group.path = QStringLiteral( "/etc/group" );
+    m_shadow.path = QStringLiteral( "/etc/shadow" );
+    m_gshadow.path = QStringLiteral( "/etc/gshadow" );
+    m_subuid.path = QStringLiteral( "/etc/subuid" );
+    m_subgid.path = QStringLiteral( "/etc/subgid" );
+}
+
+QString
+UserDatabase::hostPath( const QString& path ) const
+{
+    return QDir( m_root ).absoluteFilePath( path.mid( 1 ) );
+}
+
+bool
+UserDatabase::readFile( File& f ) const
+{
+    f.entries.clear();
+    f.changed = false;
+    QFile file( hostPath( f.path ) );
+    f.exists = file.exists();
+    if ( !f.exists )
+    {
+        return true;
+    }
+    if ( !file.open( QIODevice::ReadOnly ) )
+    {
+        cWarning() << "Cannot read" << file.fileName();
+        return false;
+    }
+
+    for ( const QByteArray& line : file.readAll().split( '\n' ) )
+    {
+        if ( line.isEmpty() )
+        {
+            continue;
+        }
+        // NIS compatibility entries are for the tools to deal with
+        if ( line.startsWith( '+' ) || line.startsWith( '-' ) )
+        {
+            cDebug() << "NIS entries in" << f.path;
+            return false;
+        }
+        f.entries.append( QString::fromLocal8Bit( line ).split( ':' ) );
+    }
+    return true;
+}
+
+/** @brief Copies the extended attributes of file @p from to @p fd
+ *
+ * This keeps the SELinux label (security.selinux), and any other
+ * attributes, of a file that is replaced. A filesystem without
+ * extended attributes has nothing to copy.
+ */
+static bool
+copyAttributes( const QByteArray& from, int fd )
+{
+    ssize_t size = ::listxattr( from.constData(), nullptr, 0 );
+    if ( size < 0 )
+    {
+        return errno == ENOTSUP;
+    }
+    QByteArray names( int( size ), '\0' );
+    size = ::listxattr( from.constData(), names.data(), size_t( names.size() ) );
+    if ( size < 0 )
+    {
+        cWarning() << "Cannot list attributes of" << from << strerror( errno );
+        return false;
+    }
+    names.truncate( int( size ) );
+
+    for ( const QByteArray& attribute : names.split( '\0' ) )
+    {
+        if ( attribute.isEmpty() )
+        {
+            continue;
+        }
+        ssize_t length = ::getxattr( from.constData(), attribute.constData(), nullptr, 0 );
+        QByteArray value( int( qMax< ssize_t >( length, 0 ) ), '\0' );
+        if ( length >= 0 )
+        {
+            length = ::getxattr( from.constData(), attribute.constData(), value.data(), size_t( value.size() ) );
+        }
+        if ( length < 0 || ::fsetxattr( fd, attribute.constData(), value.constData(), size_t( length ), 0 ) != 0 )
+        {
+            cWarning() << "Cannot copy attribute" << attribute << "of" << from << strerror( errno );
+            return false;
+        }
+    }
+    return true;
+}
+
+/** @brief Replaces the file with the new contents
+ *
+ * The new contents are written to a temporary file next to it, with
+ * the same ownership, mode and extended attributes (e.g. the SELinux
+ * label), which is then renamed over it; so the file is always complete.
+ */
+bool
+UserDatabase::writeFile( const File& f ) const
+{
+    QByteArray contents;
+    for ( const auto& e : f.entries )
+    {
+        contents.append( e.join( ':' ).toLocal8Bit() ).append( '\n' );
+    }
+
+    const QByteArray name = QFile::encodeName( hostPath( f.path ) );
+    const QByteArray temporary = name + '+';
+    struct stat st;
+    if ( ::stat( name.constData(), &st ) != 0 )
+    {
+        cWarning() << "Cannot stat" << name << strerror( errno );
+        return false;
+    }
+
+    int fd = ::open( temporary.constData(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600 );
+    if ( fd < 0 )
+    {
+        cWarning() << "Cannot create" << temporary << strerror( errno );
+        return false;
+    }
+    bool ok = ( ::fchown( fd, st.st_uid, st.st_gid ) == 0 ) && ( ::fchmod( fd, st.st_mode & 07777 ) == 0 )
+        && copyAttributes( name, fd );
+    const char* data = contents.constData();
+    qint64 remaining = contents.size();
+    while ( ok && remaining > 0 )
+    {
+        const ssize_t written = ::write( fd, data, size_t( remaining ) );
+        if ( written < 0 && errno != EINTR )
+        {
+            ok = false;
+        }
+        else if ( written > 0 )
+        {
+            data += written;
+            remaining -= written;
+        }
+    }
+    ok = ok && ( ::fsync( fd ) == 0 );
+    ok = ( ::close( fd ) == 0 ) && ok;
+    ok = ok && ( ::rename( temporary.constData(), name.constData() ) == 0 );
+    if ( !ok )
+    {
+        cWarning() << "Cannot write" << name << strerror( errno );
+        ::unlink( temporary.constData() );
+    }
+    return ok;
+}
+
+int
+UserDatabase::loginDefsValue( const QString& key, int defaultValue ) const
+{
+    bool ok = false;
+    // Base 0, since UMASK and HOME_MODE are octal
+    const int value = m_loginDefs.value( key ).toInt( &ok, 0 );
+    return ok ? value : defaultValue;
+}
+
+bool
+UserDatabase::load()
+{
+    m_loginDefs = readSettings( hostPath( QStringLiteral( "/etc/login.defs" ) ), ' ' );
+    m_useraddDefaults = readSettings( hostPath( QStringLiteral( "/etc/default/useradd" ) ), '=' );
+
+    for ( File* f : { &m_passwd, &m_group, &m_shadow, &m_gshadow, &m_subuid, &m_subgid } )
+    {
+        if ( !readFile( *f ) )
+        {
+            return false;
+        }
+    }
+    if ( !m_passwd.exists || !m_group.exists || !m_shadow.exists )
+    {
+        cDebug() << "The user database in" << m_root << "is incomplete.";
+        return false;
+    }
+    return true;
+}
+
+bool
+UserDatabase::hasUser( const QString& name ) const
+{
+    return findEntry( m_passwd.entries, name ) >= 0;
+}
+
+bool
+UserDatabase::hasGroup( const QString& name ) const
+{
+    return findEntry( m_group.entries, name ) >= 0;
+}
+
+int
+UserDatabase::uid( const QString& name ) const
+{
+    return idOf( m_passwd.entries, name );
+}
+
+int
+UserDatabase::gid( const QString& name ) const
+{
+    return idOf( m_group.entries, name );
+}
+
+int
+UserDatabase::addGroup( const QString& name )
+{
+    if ( hasGroup( name ) )
+    {
+        return gid( name );
+    }
+    if ( name.isEmpty() || name.contains( ':' ) )
+    {
+        return -1;
+    }
+
+    const int id = nextId( m_group.entries, loginDefsValue( "GID_MIN", 1000 ), loginDefsValue( "GID_MAX", 60000 ) );
+    if ( id < 0 )
+    {
+        return -1;
+    }
+    m_group.entries.append( QStringList { name, QStringLiteral( "x" ), QString::number( id ), QString() } );
+    m_group.changed = true;
+    if ( m_gshadow.exists )
+    {
+        m_gshadow.entries.append( QStringList { name, QStringLiteral( "!" ), QString(), QString() } );
+        m_gshadow.changed = true;
+    }
+    return id;
+}
+
+void
+UserDatabase::addSubordinateIds( File& f, const QString& name, const QString& prefix )
+{
+    const int count = loginDefsValue( prefix + QStringLiteral( "_COUNT" ), 65536 );
+    const qint64 min = loginDefsValue( prefix + QStringLiteral( "_MIN" ), 100000 );
+    const qint64 max = loginDefsValue( prefix + QStringLiteral( "_MAX" ), 600100000 );
+    if ( !f.exists || count <= 0 )
+    {
+        return;
+    }
+
+    // After the last range that is handed out already
+    qint64 start = min;
+    for ( const auto& e : f.entries )
+    {
+        if ( e.count() > 2 )
+        {
+            start = qMax( start, e.at( 1 ).toLongLong() + e.at( 2 ).toLongLong() );
+        }
+    }
+    if ( start + count - 1 > max )
+    {
+        cWarning() << "No subordinate ids left in" << f.path << "for" << name;
+        return;
+    }
+    f.entries.append( QStringList { name, QString::number( start ), QString::number( count ) } );
+    f.changed = true;
+}
+
+int
+UserDatabase::addUser( const QString& name, const QString& fullName, const QString& home, const QString& shell )
+{
+    if ( name.isEmpty() || hasUser( name ) || hasGroup( name ) )
+    {
+        return -1;
+    }
+    if ( fullName.contains( ':' ) || fullName.contains( '\n' ) )
+    {
+        return -1;
+    }
+    // The tools know how to create a mail spool
+    if ( m_useraddDefaults.value( "CREATE_MAIL_SPOOL" ).toLower() == QStringLiteral( "yes" ) )
+    {
+        return -1;
+    }
+
+    const int uid = nextId( m_passwd.entries, loginDefsValue( "UID_MIN", 1000 ), loginDefsValue( "UID_MAX", 60000 ) );
+    if ( uid < 0 )
+    {
+        return -1;
+    }
+    // Like useradd -U, use the same number for the group if possible
+    const int gid = isIdUsed( m_group.entries, uid )
+        ? nextId( m_group.entries, loginDefsValue( "GID_MIN", 1000 ), loginDefsValue( "GID_MAX", 60000 ) )
+        : uid;
+    if ( gid < 0 )
+    {
+        return -1;
+    }
+
+    const QString userShell = shell.isEmpty() ? m_useraddDefaults.value( "SHELL" ) : shell;
+    m_passwd.entries.append( QStringList {
+        name, QStringLiteral( "x" ), QString::number( uid ), QString::number( gid ), fullName, home, userShell } );
+    m_passwd.changed = true;
+    m_group.entries.append( QStringList { name, QStringLiteral( "x" ), QString::number( gid ), QString() } );
+    m_group.changed = true;
+
+    // Password aging as in login.defs; empty fields when not set
+    auto aging = [this]( const char* key ) {
+        const int value = loginDefsValue( key, -1 );
+        return value < 0 ? QString() : QString::number( value );
+    };
+    m_shadow.entries.append( QStringList { name,
+                                           QStringLiteral( "!" ),
+                                           today(),
+                                           aging( "PASS_MIN_DAYS" ),
+                                           aging( "PASS_MAX_DAYS" ),
+                                           aging( "PASS_WARN_AGE" ),
+                                           QString(),
+                                           QString(),
+                                           QString() } );
+    m_shadow.changed = true;
+    if ( m_gshadow.exists )
+    {
+        m_gshadow.entries.append( QStringList { name, QStringLiteral( "!" ), QString(), QString() } );
+        m_gshadow.changed = true;
+    }
+
+    addSubordinateIds( m_subuid, name, QStringLiteral( "SUB_UID" ) );
+    addSubordinateIds( m_subgid, name, QStringLiteral( "SUB_GID" ) );
+    return uid;
+}
+
+/// @brief Adds @p name to the comma-separated list in field @p index of @p entry
+static void
+addMember( QStringList& entry, int index, const QString& name )
+{
+    while ( entry.count() <= index )
+    {
+        entry.append( QString() );
+    }
+    QStringList members = entry.at( index ).split( ',', QString::SkipEmptyParts );
+    if ( !members.contains( name ) )
+    {
+        members.append( name );
+        entry[ index ] = members.join( ',' );
+    }
+}
+
+bool
+UserDatabase::addToGroups( const QString& name, const QStringList& groups )
+{
+    for ( const QString& group : groups )
+    {
+        const int i = findEntry( m_group.entries, group );
+        if ( i < 0 )
+        {
+            cWarning() << "Group" << group << "does not exist.";
+            return false;
+        }
+        addMember( m_group.entries[ i ], 3, name );
+        m_group.changed = true;
+
+        const int gi = findEntry( m_gshadow.entries, group );
+        if ( gi >= 0 )
+        {
+            addMember( m_gshadow.entries[ gi ], 3, name );
+            m_gshadow.changed = true;
+        }
+    }
+    return true;
+}
+
+bool
+UserDatabase::setPassword( const QString& name, const QString& encrypted )
+{
+    const int i = findEntry( m_shadow.entries, name );
+    if ( i < 0 || m_shadow.entries.at( i ).count() < 3 || encrypted.contains( ':' ) )
+    {
+        return false;
+    }
+    m_shadow.entries[ i ][ 1 ] = encrypted;
+    m_shadow.entries[ i ][ 2 ] = today();
+    m_shadow.changed = true;
+    return true;
+}
+
+bool
+UserDatabase::save()
+{
+    // Groups first, so that a user never refers to a missing group
+    for ( const File* f : { &m_group, &m_gshadow, &m_subuid, &m_subgid, &m_passwd, &m_shadow } )
+    {
+        if ( f->changed && !writeFile( *f ) )
+        {
+            return false;
+        }
+    }
+    for ( File* f : { &m_group, &m_gshadow, &m_subuid, &m_subgid, &m_passwd, &m_shadow } )
+    {
+        f->changed = false;
+    }
+    return true;
+}
+
+QString
+UserDatabase::skeleton() const
+{
+    return hostPath( m_useraddDefaults.value( "SKEL", QStringLiteral( "/etc/skel" ) ) );
+}
+
+mode_t
+UserDatabase::homeMode() const
+{
+    const int homeMode = loginDefsValue( "HOME_MODE", -1 );
+    if ( homeMode >= 0 )
+    {
+        return mode_t( homeMode & 07777 );
+    }
+    return mode_t( 0777 & ~loginDefsValue( "UMASK", 022 ) );
+}
+
+/// @brief Copies the contents of directory @p from into @p to, owned by @p uid and @p gid
+static bool
+copyTree( const QString& from, const QString& to, uid_t uid, gid_t gid )
+{
+    const QFileInfoList entries
+        = QDir( from ).entryInfoList( QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System );
+    for ( const QFileInfo& fi : entries )
+    {
+        const QByteArray source = QFile::encodeName( fi.absoluteFilePath() );
+        const QByteArray target = QFile::encodeName( QDir( to ).absoluteFilePath( fi.fileName() ) );
+        struct stat st;
+        if ( ::lstat( source.constData(), &st ) != 0 )
+        {
+            return false;
+        }
+
+        bool ok = true;
+        if ( S_ISLNK( st.st_mode ) )
+        {
+            char link[ PATH_MAX ];
+            const ssize_t length = ::readlink( source.constData(), link, sizeof( link ) - 1 );
+            ok = length >= 0;
+            if ( ok )
+            {
+                link[ length ] = '\0';
+                ok = ::symlink( link, target.constData() ) == 0;
+            }
+        }
+        else if ( S_ISDIR( st.st_mode ) )
+        {
+            ok = ::mkdir( target.constData(), 0700 ) == 0;
+        }
+        else if ( S_ISREG( st.st_mode ) )
+        {
+            ok = QFile::copy( fi.absoluteFilePath(), QFile::decodeName( target ) );
+        }
+        else
+        {
+            cDebug() << "Skipping special file" << fi.absoluteFilePath();
+            continue;
+        }
+
+        // Owned by the user right away; mode after the owner, which could clear it
+        ok = ok && ::lchown( target.constData(), uid, gid ) == 0;
+        ok = ok && ( S_ISLNK( st.st_mode ) || ::chmod( target.constData(), st.st_mode & 07777 ) == 0 );
+        ok = ok
+            && ( !S_ISDIR( st.st_mode ) || copyTree( fi.absoluteFilePath(), QFile::decodeName( target ), uid, gid ) );
+        if ( !ok )
+        {
+            cWarning() << "Cannot copy" << fi.absoluteFilePath() << "to" << target << strerror( errno );
+            return false;
+        }
+    }
+    return true;
+}
+
+bool
+createHome( const QString& home, const QString& skeleton, uid_t uid, gid_t gid, mode_t mode )
+{
+    const QByteArray path = QFile::encodeName( home );
+    QDir().mkpath( QFileInfo( home ).absolutePath() );
+    if ( ::mkdir( path.constData(), 0700 ) != 0 || ::chown( path.constData(), uid, gid ) != 0
+         || ::chmod( path.constData(), mode ) != 0 )
+    {
+        cWarning() << "Cannot create home directory" << home << strerror( errno );
+        return false;
+    }
+    return !QFileInfo( skeleton ).isDir() || copyTree( skeleton, home, uid, gid );
+}
+
+bool
+changeOwnerRecursive( const QString& path, uid_t uid, gid_t gid )
+{
+    const QByteArray name = QFile::encodeName( path );
+    struct stat st;
+    if ( ::lstat( name.constData(), &st ) != 0 || ::lchown( name.constData(), uid, gid ) != 0 )
+    {
+        cWarning() << "Cannot change owner of" << path << strerror( errno );
+        return false;
+    }
+    if ( S_ISDIR( st.st_mode ) )
+    {
+        const QFileInfoList entries
+            = QDir( path ).entryInfoList( QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System );
+        for ( const QFileInfo& fi : entries )
+        {
+            if ( !changeOwnerRecursive( fi.absoluteFilePath(), uid, gid ) )
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,128 @@
+/* === This file is part of Calamares - <https://github.com/calamares> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Calamares is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Calamares is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Calamares. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef USERS_USERDATABASE_H
+#define USERS_USERDATABASE_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include <sys/types.h>
+
+/** @brief Direct access to the user database of the target system
+ *
+ * This reads /etc/passwd, /etc/group, /etc/shadow and /etc/gshadow
+ * (and the subordinate-id files /etc/subuid and /etc/subgid, if they
+ * exist) from the target, makes changes in memory and then writes
+ * all of the changed files back in one go. That replaces a series of
+ * groupadd, useradd and usermod calls, each of which runs in a chroot.
+ *
+ * Settings (id ranges, password aging) are read from /etc/login.defs
+ * and /etc/default/useradd in the target, as the tools do.
+ *
+ * When load() or one of the changes fails, nothing has been written
+ * yet; use the tools instead, which also give a sensible error
+ * message for the user.
+ */
+class UserDatabase
+{
+public:
+    explicit UserDatabase( const QString& root );
+
+    /** @brief Reads the database
+     *
+     * Returns @c false if the files cannot be read, or use features
+     * (like NIS entries) that are left to the tools.
+     */
+    bool load();
+
+    bool hasUser( const QString& name ) const;
+    bool hasGroup( const QString& name ) const;
+
+    /// @brief The uid of user @p name, or -1
+    int uid( const QString& name ) const;
+    /// @brief The gid of group @p name, or -1
+    int gid( const QString& name ) const;
+
+    /// @brief Adds group @p name (like groupadd), returns the gid or -1
+    int addGroup( const QString& name );
+
+    /** @brief Adds user @p name, with a group of the same name
+     *
+     * This is like `useradd -U`; the user's password is locked until
+     * it is set. Returns the uid, or -1 if the user or group already
+     * exists, there is no free id, or the settings of the target ask
+     * for something that useradd does better.
+     */
+    int addUser( const QString& name, const QString& fullName, const QString& home, const QString& shell );
+
+    /// @brief Adds user @p name to each of @p groups (like usermod -aG)
+    bool addToGroups( const QString& name, const QStringList& groups );
+
+    /// @brief Sets the (encrypted) password of user @p name (like usermod -p)
+    bool setPassword( const QString& name, const QString& encrypted );
+
+    /// @brief Writes back all of the files that were changed
+    bool save();
+
+    /// @brief The skeleton directory (from /etc/default/useradd), in the target
+    QString skeleton() const;
+    /// @brief The mode for new home directories (from /etc/login.defs)
+    mode_t homeMode() const;
+
+private:
+    struct File
+    {
+        QString path;  ///< From the root of the target
+        QList< QStringList > entries;
+        bool exists = false;
+        bool changed = false;
+    };
+
+    QString hostPath( const QString& path ) const;
+    bool readFile( File& f ) const;
+    bool writeFile( const File& f ) const;
+    int loginDefsValue( const QString& key, int defaultValue ) const;
+    void addSubordinateIds( File& f, const QString& name, const QString& prefix );
+
+    QString m_root;
+    File m_passwd;
+    File m_group;
+    File m_shadow;
+    File m_gshadow;
+    File m_subuid;
+    File m_subgid;
+    QHash< QString, QString > m_loginDefs;
+    QHash< QString, QString > m_useraddDefaults;
+};
+
+/** @brief Creates home directory @p home, owned by @p uid and @p gid
+ *
+ * The contents of @p skeleton are copied into it, and each copy
+ * is owned by the user as soon as it is created. Paths are in the
+ * host system.
+ */
+bool createHome( const QString& home, const QString& skeleton, uid_t uid, gid_t gid, mode_t mode );
+
+/// @brief Gives @p path and everything under it to @p uid and @p gid (like chown -R)
+bool changeOwnerRecursive( const QString& path, uid_t uid, gid_t gid );
+
+#endif
@@ -0,0 +1,204 @@
+/* === This file is part of Calamares - <https://github.com/calamares> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Calamares is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Calamares is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Calamares. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "UserDatabaseTests.h"
+
+#include "UserDatabase.h"
+
+#include "utils/Logger.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QtTest/QtTest>
+
+#include <sys/stat.h>
+#include <sys/xattr.h>
+#include <unistd.h>
+
+QTEST_GUILESS_MAIN( UserDatabaseTests )
+
+/// @brief Writes @p contents to @p path under @p root, returns @c true on success
+static bool
+writeFile( const QString& root, const QString& path, const QByteArray& contents )
+{
+    QFile f( root + path );
+    return f.open( QIODevice::WriteOnly ) && f.write( contents ) == contents.size();
+}
+
+/// @brief The lines of @p path under @p root
+static QStringList
+readLines( const QString& root, const QString& path )
+{
+    QFile f( root + path );
+    if ( !f.open( QIODevice::ReadOnly ) )
+    {
+        return QStringList();
+    }
+    return QString::fromLocal8Bit( f.readAll() ).split( '\n', QString::SkipEmptyParts );
+}
+
+/// @brief Creates a minimal user database under @p root, returns @c true on success
+static bool
+makeDatabase( const QString& root )
+{
+    return QDir( root ).mkpath( "etc/skel/.config" )
+        && writeFile( root, "/etc/passwd", "root:x:0:0:root:/root:/bin/bash\nold:x:1000:1000::/home/old:/bin/sh\n" )
+        && writeFile( root, "/etc/group", "root:x:0:\nwheel:x:10:\nold:x:1000:\n" )
+        && writeFile( root, "/etc/shadow", "root:*:18000:0:99999:7:::\nold:!:18000::::::\n" )
+        && writeFile( root, "/etc/gshadow", "root:::\nwheel:::\nold:!::\n" )
+        && writeFile( root, "/etc/subuid", "old:100000:65536\n" )
+        && writeFile( root,
+                      "/etc/login.defs",
+                      "# Comment\nUID_MIN 1000\nUID_MAX\t60000\nPASS_MAX_DAYS 99999\nUMASK 077\n" )
+        && writeFile( root, "/etc/skel/.profile", "# profile\n" )
+        && QFile::link( ".profile", root + "/etc/skel/.bashrc" );
+}
+
+UserDatabaseTests::UserDatabaseTests() {}
+
+UserDatabaseTests::~UserDatabaseTests() {}
+
+void
+UserDatabaseTests::initTestCase()
+{
+    Logger::setupLogLevel( Logger::LOGDEBUG );
+}
+
+void
+UserDatabaseTests::testAddUser()
+{
+    QTemporaryDir dir;
+    QVERIFY( dir.isValid() );
+    const QString root = dir.path();
+    QVERIFY( makeDatabase( root ) );
+    ::chmod( QFile::encodeName( root + "/etc/shadow" ).constData(), 0640 );
+
+    UserDatabase db( root );
+    QVERIFY( db.load() );
+    QVERIFY( db.hasUser( "old" ) );
+    QVERIFY( !db.hasUser( "new" ) );
+
+    // Existing groups are not added again
+    QCOMPARE( db.addGroup( "wheel" ), 10 );
+    QCOMPARE( db.addGroup( "audio" ), 1001 );
+    // Existing user fails
+    QCOMPARE( db.addUser( "old", "Old", "/home/old", QString() ), -1 );
+    // New user gets the next uid, and the group can't have the same number
+    QCOMPARE( db.addUser( "new", "New User", "/home/new", "/bin/zsh" ), 1001 );
+    QCOMPARE( db.gid( "new" ), 1002 );
+    QVERIFY( db.addToGroups( "new", { "wheel", "audio" } ) );
+    QVERIFY( !db.addToGroups( "new", { "nonexistent" } ) );
+    QVERIFY( db.save() );
+
+    QVERIFY( readLines( root, "/etc/passwd" ).contains( "new:x:1001:1002:New User:/home/new:/bin/zsh" ) );
+    const QStringList groups = readLines( root, "/etc/group" );
+    QVERIFY( groups.contains( "wheel:x:10:new" ) );
+    QVERIFY( groups.contains( "audio:x:1001:new" ) );
+    QVERIFY( groups.contains( "new:x:1002:" ) );
+    QVERIFY( readLines( root, "/etc/gshadow" ).contains( "wheel:::new" ) );
+    QVERIFY( readLines( root, "/etc/subuid" ).contains( "new:165536:65536" ) );
+    // No subgid file, so none is created
+    QVERIFY( !QFileInfo::exists( root + "/etc/subgid" ) );
+
+    const QStringList shadow = readLines( root, "/etc/shadow" );
+    QCOMPARE( shadow.count(), 3 );
+    QVERIFY( shadow.last().startsWith( "new:!:" ) );
+    QVERIFY( shadow.last().endsWith( "::99999::::" ) );
+    // The mode of the file is kept
+    QCOMPARE( QFileInfo( root + "/etc/shadow" ).permissions(),
+              QFileDevice::ReadOwner | QFileDevice::WriteOwner | QFileDevice::ReadUser | QFileDevice::WriteUser
+                  | QFileDevice::ReadGroup );
+    QVERIFY( !QFileInfo::exists( root + "/etc/shadow+" ) );
+}
+
+void
+UserDatabaseTests::testSetPassword()
+{
+    QTemporaryDir dir;
+    QVERIFY( dir.isValid() );
+    const QString root = dir.path();
+    QVERIFY( makeDatabase( root ) );
+
+    UserDatabase db( root );
+    QVERIFY( db.load() );
+    QVERIFY( !db.setPassword( "nobody", "$6$salt$hash" ) );
+    QVERIFY( db.setPassword( "old", "$6$salt$hash" ) );
+    QVERIFY( db.save() );
+
+    const QStringList shadow = readLines( root, "/etc/shadow" );
+    QCOMPARE( shadow.first(), QStringLiteral( "root:*:18000:0:99999:7:::" ) );
+    QVERIFY( shadow.last().startsWith( "old:$6$salt$hash:" ) );
+    QVERIFY( !shadow.last().startsWith( "old:$6$salt$hash:18000:" ) );
+}
+
+void
+UserDatabaseTests::testCreateHome()
+{
+    QTemporaryDir dir;
+    QVERIFY( dir.isValid() );
+    const QString root = dir.path();
+    QVERIFY( makeDatabase( root ) );
+
+    UserDatabase db( root );
+    QVERIFY( db.load() );
+    QCOMPARE( db.skeleton(), root + "/etc/skel" );
+    QCOMPARE( int( db.homeMode() ), 0700 );
+
+    // Use our own ids, which we are allowed to chown to
+    const QString home = root + "/home/new";
+    QVERIFY( createHome( home, db.skeleton(), ::getuid(), ::getgid(), db.homeMode() ) );
+    QVERIFY( QFileInfo( home ).isDir() );
+    QVERIFY( QFileInfo( home + "/.config" ).isDir() );
+    QVERIFY( QFileInfo( home + "/.profile" ).isFile() );
+    QVERIFY( QFileInfo( home + "/.bashrc" ).isSymLink() );
+    QCOMPARE( QFileInfo( home + "/.bashrc" ).symLinkTarget(), home + "/.profile" );
+    QCOMPARE( QFileInfo( home + "/.profile" ).ownerId(), ::getuid() );
+
+    // Already exists
+    QVERIFY( !createHome( home, db.skeleton(), ::getuid(), ::getgid(), db.homeMode() ) );
+    QVERIFY( changeOwnerRecursive( home, ::getuid(), ::getgid() ) );
+}
+
+void
+UserDatabaseTests::testKeepAttributes()
+{
+    QTemporaryDir dir;
+    QVERIFY( dir.isValid() );
+    const QString root = dir.path();
+    QVERIFY( makeDatabase( root ) );
+
+    // The user namespace stands in for security.selinux, which needs privileges
+    const QByteArray shadow = QFile::encodeName( root + "/etc/shadow" );
+    const QByteArray label( "system_u:object_r:shadow_t:s0" );
+    if ( ::setxattr( shadow.constData(), "user.test", label.constData(), size_t( label.size() ), 0 ) != 0 )
+    {
+        QSKIP( "No extended attributes in the temporary directory." );
+    }
+
+    UserDatabase db( root );
+    QVERIFY( db.load() );
+    QVERIFY( db.setPassword( "old", "$6$salt$hash" ) );
+    QVERIFY( db.save() );
+    QVERIFY( readLines( root, "/etc/shadow" ).last().startsWith( "old:$6$salt$hash:" ) );
+
+    char value[ 64 ] = {};
+    const ssize_t length = ::getxattr( shadow.constData(), "user.test", value, sizeof( value ) );
+    QCOMPARE( QByteArray( value, int( qMax< ssize_t >( length, 0 ) ) ), label );
+}
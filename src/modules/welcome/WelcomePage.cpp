@@ -221,6 +221,12 @@ WelcomePage::verdict() const
     return m_checkingWidget->verdict();
 }
 
+void
+WelcomePage::requirementUpdated( const Calamares::RequirementEntry& entry )
+{
+    m_checkingWidget->requirementUpdated( entry );
+}
+
 void
 WelcomePage::externallySelectedLanguage( int row )
 {
@@ -30,6 +30,11 @@ namespace Ui
 class WelcomePage;
 }
 
+namespace Calamares
+{
+struct RequirementEntry;
+}
+
 class CheckerContainer;
 
 class WelcomePage : public QWidget
@@ -55,6 +60,9 @@ public:
     /// @brief Results of requirements checking
     bool verdict() const;
 
+    /// @brief A requirement has a new result, after checking was done
+    void requirementUpdated( const Calamares::RequirementEntry& entry );
+
     /// @brief Change the language from an external source.
     void externallySelectedLanguage( int row );
 
@@ -44,6 +44,13 @@ WelcomeViewStep::WelcomeViewStep( QObject* parent )
              this,
              &WelcomeViewStep::nextStatusChanged );
     m_widget = new WelcomePage();
+    connect( m_requirementsChecker,
+             &GeneralRequirements::requirementUpdated,
+             this,
+             [this]( const Calamares::RequirementEntry& entry ) {
+                 m_widget->requirementUpdated( entry );
+                 emit nextStatusChanged( m_widget->verdict() );
+             } );
 }
 
 
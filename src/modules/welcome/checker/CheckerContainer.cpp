@@ -29,6 +29,8 @@
 #include "utils/Retranslator.h"
 #include "widgets/WaitingWidget.h"
 
+#include <algorithm>
+
 CheckerContainer::CheckerContainer( QWidget* parent )
     : QWidget( parent )
     , m_waitingWidget( new WaitingWidget( QString(), this ) )
@@ -59,16 +61,54 @@ void CheckerContainer::requirementsComplete( bool ok )
     m_waitingWidget->deleteLater();
     m_waitingWidget = nullptr;  // Don't delete in destructor
 
-    m_checkerWidget = new ResultsListWidget( this );
-    m_checkerWidget->init( m_requirements );
-    layout()->addWidget( m_checkerWidget );
-
-    m_verdict = ok;
+    // The verdict is re-computed from the entries, which may already
+    // include updates that @p ok does not know about.
+    Q_UNUSED( ok )
+    showResults();
 }
 
 void CheckerContainer::requirementsChecked(const Calamares::RequirementsList& l)
 {
-    m_requirements.append( l );
+    for ( const auto& r : l )
+    {
+        m_requirements.append( m_updates.contains( r.name ) ? m_updates.take( r.name ) : r );
+    }
+}
+
+void CheckerContainer::requirementUpdated( const Calamares::RequirementEntry& entry )
+{
+    auto it = std::find_if( m_requirements.begin(),
+                            m_requirements.end(),
+                            [&entry]( const Calamares::RequirementEntry& r ) { return r.name == entry.name; } );
+    if ( it == m_requirements.end() )
+    {
+        // Not reported yet, apply it when it is
+        m_updates.insert( entry.name, entry );
+        return;
+    }
+
+    *it = entry;
+    if ( m_checkerWidget )
+    {
+        showResults();
+    }
+}
+
+void CheckerContainer::showResults()
+{
+    if ( m_checkerWidget )
+    {
+        layout()->removeWidget( m_checkerWidget );
+        m_checkerWidget->deleteLater();
+    }
+
+    m_checkerWidget = new ResultsListWidget( this );
+    m_checkerWidget->init( m_requirements );
+    layout()->addWidget( m_checkerWidget );
+
+    m_verdict = std::none_of( m_requirements.cbegin(),
+                              m_requirements.cend(),
+                              []( const Calamares::RequirementEntry& r ) { return r.mandatory && !r.satisfied; } );
 }
 
 void CheckerContainer::requirementsProgress(const QString& message)
@@ -23,6 +23,7 @@
 #ifndef CHECKERCONTAINER_H
 #define CHECKERCONTAINER_H
 
+#include <QMap>
 #include <QWidget>
 
 #include "modulesystem/Requirement.h"
@@ -53,11 +54,23 @@ public slots:
 
     void requirementsProgress( const QString& message );
 
+    /** @brief A requirement has a new result
+     *
+     * The entry with the same name is replaced; if the results are
+     * already shown, the list and the verdict are updated.
+     */
+    void requirementUpdated( const Calamares::RequirementEntry& );
+
 protected:
+    /// @brief (Re)create the list of results and re-compute the verdict
+    void showResults();
+
     WaitingWidget *m_waitingWidget;
     ResultsListWidget *m_checkerWidget;
 
     Calamares::RequirementsList m_requirements;
+    /// Updates for entries that have not been reported yet
+    QMap< QString, Calamares::RequirementEntry > m_updates;
     bool m_verdict;
 } ;
 
@@ -26,6 +26,7 @@
 
 #include "modulesystem/Requirement.h"
 #include "network/Manager.h"
+#include "partition/DeviceInventory.h"
 #include "widgets/WaitingWidget.h"
 #include "utils/CalamaresUtilsGui.h"
 #include "utils/Logger.h"
@@ -41,22 +42,72 @@
 #include <QApplication>
 #include <QBoxLayout>
 #include <QDBusConnection>
-#include <QDBusInterface>
+#include <QDBusMessage>
+#include <QDBusVariant>
 #include <QDesktopWidget>
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
 #include <QLabel>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFutureWatcher>
+#include <QMutexLocker>
 #include <QProcess>
 #include <QTimer>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
 
 #include <unistd.h> //geteuid
 
+/** @brief Wait for @p future, but not longer than @p timeoutMs
+ *
+ * Returns true if the future has finished. This runs a local event
+ * loop, so it can be used from the thread that checks requirements.
+ * The timeout may be 0, which only picks up a future that is done.
+ */
+static bool
+waitForCheck( const QFuture< void >& future, int timeoutMs )
+{
+    QEventLoop loop;
+    QFutureWatcher< void > watcher;
+    QTimer timeout;
+    timeout.setSingleShot( true );
+    QObject::connect( &watcher, &QFutureWatcher< void >::finished, &loop, &QEventLoop::quit );
+    QObject::connect( &timeout, &QTimer::timeout, &loop, &QEventLoop::quit );
+
+    // The watcher reports finished() for an already-finished future, too
+    watcher.setFuture( future );
+    timeout.start( timeoutMs );
+    loop.exec();
+    return future.isFinished();
+}
+
 GeneralRequirements::GeneralRequirements( QObject* parent )
     : QObject( parent )
     , m_requiredStorageGiB( -1 )
     , m_requiredRamGiB( -1 )
 {
+    // The internet check does not wait for the network; a result
+    // that comes in later updates the requirement.
+    connect( &CalamaresUtils::Network::Manager::instance(),
+             &CalamaresUtils::Network::Manager::checkHasInternetDone,
+             this,
+             [this]( bool hasInternet ) {
+                 if ( m_entriesToCheck.contains( "internet" ) )
+                 {
+                     emit requirementUpdated( requirementEntry( QStringLiteral( "internet" ), hasInternet ) );
+                 }
+             } );
+}
+
+GeneralRequirements::~GeneralRequirements()
+{
+    // The checks use this object, so they may not outlive it; a check
+    // that is stuck (e.g. on a hanging disk) delays shutdown instead.
+    m_storageCheck.waitForFinished();
+    m_powerCheck.waitForFinished();
 }
 
 Calamares::RequirementsList GeneralRequirements::checkRequirements()
@@ -64,34 +115,81 @@ Calamares::RequirementsList GeneralRequirements::checkRequirements()
     QSize availableSize = qApp->desktop()->availableGeometry().size();
 
     bool enoughStorage = false;
+    bool storageUnknown = false;
     bool enoughRam = false;
     bool hasPower = false;
     bool hasInternet = false;
     bool isRoot = false;
     bool enoughScreen = (availableSize.width() >= CalamaresUtils::windowMinimumWidth) && (availableSize.height() >= CalamaresUtils::windowMinimumHeight);
 
+    // Probing all the disks, and asking UPower, can be slow, so those
+    // start first and run alongside the other checks. If they take
+    // too long, storage is reported as not known yet (its result comes
+    // later through requirementUpdated()) and power counts as OK, since
+    // not being able to tell is not a reason to stop the user.
+    QElapsedTimer clock;
+    clock.start();
     qint64 requiredStorageB = CalamaresUtils::GiBtoBytes(m_requiredStorageGiB);
     cDebug() << "Need at least storage bytes:" << requiredStorageB;
+    QFuture< void > storageCheck;
     if ( m_entriesToCheck.contains( "storage" ) )
-        enoughStorage = checkEnoughStorage( requiredStorageB );
+    {
+        storageCheck = startStorageCheck( requiredStorageB );
+    }
+
+    QFuture< void > powerCheck;
+    if ( m_entriesToCheck.contains( "power" ) )
+    {
+        powerCheck = startPowerCheck();
+    }
 
     qint64 requiredRamB = CalamaresUtils::GiBtoBytes(m_requiredRamGiB);
     cDebug() << "Need at least ram bytes:" << requiredRamB;
     if ( m_entriesToCheck.contains( "ram" ) )
         enoughRam = checkEnoughRam( requiredRamB );
 
-    if ( m_entriesToCheck.contains( "power" ) )
-        hasPower = checkHasPower();
+    if ( m_entriesToCheck.contains( "root" ) )
+        isRoot = checkIsRoot();
 
+    // The internet probes were started when the configuration was read;
+    // this takes what is known now, and a later result is an update.
     if ( m_entriesToCheck.contains( "internet" ) )
         hasInternet = checkHasInternet();
 
-    if ( m_entriesToCheck.contains( "root" ) )
-        isRoot = checkIsRoot();
+    if ( m_entriesToCheck.contains( "storage" ) )
+    {
+        waitForCheck( storageCheck, qMax< int >( 0, 30000 - int( clock.elapsed() ) ) );
+        QMutexLocker lock( &m_checkMutex );
+        if ( m_storageDone )
+        {
+            enoughStorage = m_enoughStorage;
+        }
+        else
+        {
+            cWarning() << "Requirement check storage timed out, its result is reported later.";
+            storageUnknown = true;
+            m_storageLate = true;
+        }
+    }
+    if ( m_entriesToCheck.contains( "power" ) )
+    {
+        waitForCheck( powerCheck, qMax< int >( 0, 5000 - int( clock.elapsed() ) ) );
+        QMutexLocker lock( &m_checkMutex );
+        if ( m_powerDone )
+        {
+            hasPower = m_hasPower;
+        }
+        else
+        {
+            cWarning() << "Requirement check power timed out, assuming power.";
+            hasPower = true;
+        }
+    }
 
     using TR = Logger::DebugRow<const char *, bool>;
     cDebug() << "GeneralRequirements output:"
                     << TR("enoughStorage", enoughStorage)
+                    << TR("storageUnknown", storageUnknown)
                     << TR("enoughRam", enoughRam)
                     << TR("hasPower", hasPower)
                     << TR("hasInternet", hasInternet)
@@ -100,62 +198,151 @@ Calamares::RequirementsList GeneralRequirements::checkRequirements()
     Calamares::RequirementsList checkEntries;
     foreach ( const QString& entry, m_entriesToCheck )
     {
+        bool satisfied = false;
         if ( entry == "storage" )
-            checkEntries.append( {
-                entry,
-                [req=m_requiredStorageGiB]{ return tr( "has at least %1 GiB available drive space" ).arg( req ); },
-                [req=m_requiredStorageGiB]{ return tr( "There is not enough drive space. At least %1 GiB is required." ).arg( req ); },
-                enoughStorage,
-                m_entriesToRequire.contains( entry )
-            } );
+            satisfied = enoughStorage;
         else if ( entry == "ram" )
-            checkEntries.append( {
-                entry,
-                [req=m_requiredRamGiB]{ return tr( "has at least %1 GiB working memory" ).arg( req ); },
-                [req=m_requiredRamGiB]{ return tr( "The system does not have enough working memory. At least %1 GiB is required." ).arg( req ); },
-                enoughRam,
-                m_entriesToRequire.contains( entry )
-            } );
+            satisfied = enoughRam;
         else if ( entry == "power" )
-            checkEntries.append( {
-                entry,
-                []{ return tr( "is plugged in to a power source" ); },
-                []{ return tr( "The system is not plugged in to a power source." ); },
-                hasPower,
-                m_entriesToRequire.contains( entry )
-            } );
+            satisfied = hasPower;
         else if ( entry == "internet" )
-            checkEntries.append( {
-                entry,
-                []{ return tr( "is connected to the Internet" ); },
-                []{ return tr( "The system is not connected to the Internet." ); },
-                hasInternet,
-                m_entriesToRequire.contains( entry )
-            } );
+            satisfied = hasInternet;
         else if ( entry == "root" )
-            checkEntries.append( {
-                entry,
-                []{ return QString(); }, //we hide it
-                []{ return Calamares::Settings::instance()->isSetupMode()
-                            ? tr( "The setup program is not running with administrator rights." )
-                            : tr( "The installer is not running with administrator rights." ); },
-                isRoot,
-                m_entriesToRequire.contains( entry )
-            } );
+            satisfied = isRoot;
         else if ( entry == "screen" )
+            satisfied = enoughScreen;
+        else
+            continue;
+
+        if ( entry == "storage" && storageUnknown )
+        {
+            // Not failed, but not known yet either; requirementUpdated()
+            // replaces this entry when the check finishes.
             checkEntries.append( {
                 entry,
-                []{ return QString(); }, // we hide it
-                []{ return Calamares::Settings::instance()->isSetupMode()
-                            ? tr( "The screen is too small to display the setup program." )
-                            : tr( "The screen is too small to display the installer." ); },
-                enoughScreen,
-                false
+                [req=m_requiredStorageGiB]{ return tr( "has at least %1 GiB available drive space" ).arg( req ); },
+                []{ return tr( "The available drive space is still being checked." ); },
+                false,
+                m_entriesToRequire.contains( entry )
             } );
+            continue;
+        }
+        checkEntries.append( requirementEntry( entry, satisfied ) );
     }
     return checkEntries;
 }
 
+QFuture< void >
+GeneralRequirements::startStorageCheck( qint64 requiredSpace )
+{
+    QMutexLocker lock( &m_checkMutex );
+    if ( !m_storageCheck.isFinished() )
+    {
+        // Don't probe the disks twice at once; the result of the
+        // running check will do.
+        cDebug() << "Storage check is already running.";
+        return m_storageCheck;
+    }
+
+    m_storageDone = false;
+    m_storageLate = false;
+    m_storageCheck = QtConcurrent::run( [this, requiredSpace]() {
+        const bool enough = checkEnoughStorage( requiredSpace );
+        bool late = false;
+        {
+            QMutexLocker lock( &m_checkMutex );
+            m_enoughStorage = enough;
+            m_storageDone = true;
+            late = m_storageLate;
+            m_storageLate = false;
+        }
+        if ( late )
+        {
+            emit requirementUpdated( requirementEntry( QStringLiteral( "storage" ), enough ) );
+        }
+    } );
+    return m_storageCheck;
+}
+
+QFuture< void >
+GeneralRequirements::startPowerCheck()
+{
+    QMutexLocker lock( &m_checkMutex );
+    if ( !m_powerCheck.isFinished() )
+    {
+        cDebug() << "Power check is already running.";
+        return m_powerCheck;
+    }
+
+    m_powerDone = false;
+    m_powerCheck = QtConcurrent::run( [this]() {
+        const bool hasPower = checkHasPower();
+        QMutexLocker lock( &m_checkMutex );
+        m_hasPower = hasPower;
+        m_powerDone = true;
+    } );
+    return m_powerCheck;
+}
+
+
+Calamares::RequirementEntry
+GeneralRequirements::requirementEntry( const QString& entry, bool satisfied ) const
+{
+    if ( entry == "storage" )
+        return {
+            entry,
+            [req=m_requiredStorageGiB]{ return tr( "has at least %1 GiB available drive space" ).arg( req ); },
+            [req=m_requiredStorageGiB]{ return tr( "There is not enough drive space. At least %1 GiB is required." ).arg( req ); },
+            satisfied,
+            m_entriesToRequire.contains( entry )
+        };
+    else if ( entry == "ram" )
+        return {
+            entry,
+            [req=m_requiredRamGiB]{ return tr( "has at least %1 GiB working memory" ).arg( req ); },
+            [req=m_requiredRamGiB]{ return tr( "The system does not have enough working memory. At least %1 GiB is required." ).arg( req ); },
+            satisfied,
+            m_entriesToRequire.contains( entry )
+        };
+    else if ( entry == "power" )
+        return {
+            entry,
+            []{ return tr( "is plugged in to a power source" ); },
+            []{ return tr( "The system is not plugged in to a power source." ); },
+            satisfied,
+            m_entriesToRequire.contains( entry )
+        };
+    else if ( entry == "internet" )
+        return {
+            entry,
+            []{ return tr( "is connected to the Internet" ); },
+            []{ return tr( "The system is not connected to the Internet." ); },
+            satisfied,
+            m_entriesToRequire.contains( entry )
+        };
+    else if ( entry == "root" )
+        return {
+            entry,
+            []{ return QString(); }, //we hide it
+            []{ return Calamares::Settings::instance()->isSetupMode()
+                        ? tr( "The setup program is not running with administrator rights." )
+                        : tr( "The installer is not running with administrator rights." ); },
+            satisfied,
+            m_entriesToRequire.contains( entry )
+        };
+    else if ( entry == "screen" )
+        return {
+            entry,
+            []{ return QString(); }, // we hide it
+            []{ return Calamares::Settings::instance()->isSetupMode()
+                        ? tr( "The screen is too small to display the setup program." )
+                        : tr( "The screen is too small to display the installer." ); },
+            satisfied,
+            false
+        };
+    return {};
+}
+
 
 void
 GeneralRequirements::setConfigurationMap( const QVariantMap& configurationMap )
@@ -243,29 +430,45 @@ GeneralRequirements::setConfigurationMap( const QVariantMap& configurationMap )
         incompleteConfiguration = true;
     }
 
-    QUrl checkInternetUrl;
-    QString checkInternetSetting = CalamaresUtils::getString( configurationMap, "internetCheckUrl" );
-    if ( !checkInternetSetting.isEmpty() )
+    QVector< QUrl > checkInternetUrls;
+    const auto checkInternetSetting = configurationMap.value( "internetCheckUrl" );
+    QStringList checkInternetStrings;
+    if ( checkInternetSetting.type() == QVariant::List )
     {
-        checkInternetUrl = QUrl( checkInternetSetting.trimmed() );
-        if ( !checkInternetUrl.isValid() )
+        checkInternetStrings = checkInternetSetting.toStringList();
+    }
+    else if ( !checkInternetSetting.toString().isEmpty() )
+    {
+        checkInternetStrings << checkInternetSetting.toString();
+    }
+    for ( const auto& s : checkInternetStrings )
+    {
+        QUrl u( s.trimmed() );
+        if ( u.isValid() )
+        {
+            checkInternetUrls.append( u );
+        }
+        else
         {
-            cWarning() << "GeneralRequirements entry 'internetCheckUrl' is invalid in welcome.conf" << checkInternetSetting
-                     << "reverting to default (http://example.com).";
-            checkInternetUrl = QUrl( "http://example.com" );
+            cWarning() << "GeneralRequirements entry 'internetCheckUrl' is invalid in welcome.conf" << s;
             incompleteConfiguration = true;
         }
     }
-    else
+    if ( checkInternetUrls.isEmpty() )
     {
         cWarning() << "GeneralRequirements entry 'internetCheckUrl' is undefined in welcome.conf,"
                     "reverting to default (http://example.com).";
-        checkInternetUrl = "http://example.com";
+        checkInternetUrls.append( QUrl( "http://example.com" ) );
         incompleteConfiguration = true;
     }
-    if ( checkInternetUrl.isValid() )
+
+    auto& nam = CalamaresUtils::Network::Manager::instance();
+    nam.setCheckHasInternetUrl( checkInternetUrls );
+    if ( m_entriesToCheck.contains( "internet" ) )
     {
-        CalamaresUtils::Network::Manager::instance().setCheckHasInternetUrl( checkInternetUrl );
+        // Start probing now, so that the result is (likely) available
+        // by the time the requirements are checked.
+        nam.checkHasInternetAsync();
     }
 
     if ( incompleteConfiguration )
@@ -278,6 +481,19 @@ GeneralRequirements::setConfigurationMap( const QVariantMap& configurationMap )
 bool
 GeneralRequirements::checkEnoughStorage( qint64 requiredSpace )
 {
+    // The shared inventory was started at launch, and the partition
+    // module looks at the same devices later.
+    using CalamaresUtils::Partition::BlockDevice;
+    using CalamaresUtils::Partition::DeviceInventory;
+    if ( DeviceInventory::isSupported() )
+    {
+        const QList< BlockDevice > devices = DeviceInventory::instance().devices();
+        return std::any_of( devices.cbegin(), devices.cend(), [requiredSpace]( const BlockDevice& d )
+        {
+            return !d.readOnly && !d.virtualOrOptical && d.size >= requiredSpace;
+        } );
+    }
+
 #ifdef WITHOUT_LIBPARTED
     Q_UNUSED( requiredSpace )
     cWarning() << "GeneralRequirements is configured without libparted.";
@@ -335,20 +551,24 @@ GeneralRequirements::checkHasPower()
         return true;
 
     cDebug() << "A battery exists, checking for mains power.";
-    QDBusInterface upowerIntf( UPOWER_SVC_NAME,
-                               UPOWER_PATH,
-                               UPOWER_INTF_NAME,
-                               QDBusConnection::systemBus() );
-
-    bool onBattery = upowerIntf.property( "OnBattery" ).toBool();
-
-    if ( !upowerIntf.isValid() )
+    // Read the property directly, with a short timeout; a QDBusInterface
+    // would introspect the service first, with the default (long) timeout.
+    QDBusMessage call = QDBusMessage::createMethodCall( UPOWER_SVC_NAME,
+                                                        UPOWER_PATH,
+                                                        QStringLiteral( "org.freedesktop.DBus.Properties" ),
+                                                        QStringLiteral( "Get" ) );
+    call << UPOWER_INTF_NAME << QStringLiteral( "OnBattery" );
+    const QDBusMessage reply = QDBusConnection::systemBus().call( call, QDBus::Block, 3000 );
+
+    if ( reply.type() != QDBusMessage::ReplyMessage || reply.arguments().isEmpty() )
     {
         // We can't talk to upower but we're obviously up and running
         // so I guess we got that going for us, which is nice...
         return true;
     }
 
+    bool onBattery = reply.arguments().first().value< QDBusVariant >().variant().toBool();
+
     // If a battery exists but we're not using it, means we got mains
     // power.
     return !onBattery;
@@ -358,10 +578,10 @@ GeneralRequirements::checkHasPower()
 bool
 GeneralRequirements::checkHasInternet()
 {
-    auto& nam = CalamaresUtils::Network::Manager::instance();
-    bool hasInternet = nam.checkHasInternet();
-    Calamares::JobQueue::instance()->globalStorage()->insert( "hasInternet", hasInternet );
-    return hasInternet;
+    // This uses a cached result if there is a recent one, and otherwise
+    // the previous result; it does not wait for the probes. The
+    // Manager publishes the result in GlobalStorage.
+    return CalamaresUtils::Network::Manager::instance().checkHasInternet();
 }
 
 
@@ -20,6 +20,8 @@
 #ifndef GENERALREQUIREMENTS_H
 #define GENERALREQUIREMENTS_H
 
+#include <QFuture>
+#include <QMutex>
 #include <QObject>
 #include <QStringList>
 
@@ -30,24 +32,57 @@ class GeneralRequirements : public QObject
     Q_OBJECT
 public:
     explicit GeneralRequirements( QObject* parent = nullptr );
+    virtual ~GeneralRequirements() override;
 
     void setConfigurationMap( const QVariantMap& configurationMap );
 
     Calamares::RequirementsList checkRequirements();
 
+signals:
+    /** @brief A requirement has a new result
+     *
+     * Checks that do not finish in time are reported by checkRequirements()
+     * with what is known at that time; their final result comes here.
+     */
+    void requirementUpdated( const Calamares::RequirementEntry& entry );
+
 private:
+    /// @brief The requirement named @p entry, with the given result
+    Calamares::RequirementEntry requirementEntry( const QString& entry, bool satisfied ) const;
+
     QStringList m_entriesToCheck;
     QStringList m_entriesToRequire;
 
-    bool checkEnoughStorage( qint64 requiredSpace );
+    /** @brief Start the slow checks in a separate thread
+     *
+     * If the check is still running from an earlier call, that one is
+     * returned instead of starting another. The results are stored in
+     * the member variables below.
+     */
+    QFuture< void > startStorageCheck( qint64 requiredSpace );
+    QFuture< void > startPowerCheck();
+
+    // The storage and power checks may be slow, and run in
+    // separate threads, so they do not use any member variables.
+    static bool checkEnoughStorage( qint64 requiredSpace );
     bool checkEnoughRam( qint64 requiredRam );
-    bool checkBatteryExists();
-    bool checkHasPower();
+    static bool checkBatteryExists();
+    static bool checkHasPower();
     bool checkHasInternet();
     bool checkIsRoot();
 
     qreal m_requiredStorageGiB;
     qreal m_requiredRamGiB;
+
+    /// Guards the state of the slow checks, which is shared with their threads
+    QMutex m_checkMutex;
+    QFuture< void > m_storageCheck;
+    QFuture< void > m_powerCheck;
+    bool m_storageDone = false;
+    bool m_storageLate = false;  ///< The storage result was not ready in time, report it later
+    bool m_enoughStorage = false;
+    bool m_powerDone = false;
+    bool m_hasPower = false;
 };
 
 #endif // REQUIREMENTSCHECKER_H